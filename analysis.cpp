@@ -1,49 +1,33 @@
 #include "wordle_tools.hpp"
+#include "scoring.hpp"
+#include "thread_pool.hpp"
 
 #include "timer.hpp"
 
 #include <algorithm>
-#include <unordered_map>
-
-struct array_hasher {
-  template<size_t n>
-  std::size_t operator()(const std::array< Clue, n > & arr) const {
-    uint64_t seed = 0;
-    for(const auto elem : arr) {
-      seed ^= std::hash<uint64_t>()(elem) + 0x9e3779b9 + (seed<<6) + (seed>>2);
-    }
-    return seed;
-  }
-};
-
-using clue_count = std::unordered_map< std::array<Clue, 5>, int, array_hasher >;
-
-clue_count get_counts(const std::vector< Word > & words, Word guess) {
-  clue_count counts;
-  for (auto w : words) counts[get_clues(guess, w)]++;
-  return counts;
-}
 
 int main() {
 
-  std::vector< std::tuple< float, std::string > > results;
-  results.reserve(all_words.size());
-  for (auto guess : all_words) {
-    clue_count counts = get_counts(all_answers, guess);
+  const Lexicon & answers = answers_lexicon();
 
-    float entropy = 0.0;
-    for (auto & [k, v] : counts) {
-      float p = float(v) / all_answers.size();
-      entropy -= p * log2f(p);
-    }
+  std::vector< std::tuple< float, std::string > > results(all_words.size());
 
-    results.push_back({entropy, guess.data});
-  }
+  double elapsed = runtime([&](){
+    thread_pool().parallel_for(all_words.size(), 256, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        Word guess = all_words[i];
+        float entropy = score(histogram(guess, answers)).entropy;
+        results[i] = {entropy, std::string(guess.data, word_length)};
+      }
+    });
+  });
 
   std::sort(results.begin(), results.end());
 
   for (auto & [entropy, word] : results) {
-    std::cout << word << ": " << entropy << std::endl;
+    std::cout << word << ": " << entropy << '\n';
   }
 
-}
\ No newline at end of file
+  std::cerr << "ranked " << all_words.size() << " guesses in " << elapsed << "s" << std::endl;
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+#include "word_list.hpp"
+
+// The word lists compiled into the binary, together with the column-wise
+// layout and letter masks a Lexicon would otherwise build at startup. It is
+// all computed by the compiler, so it sits in read-only data, and using it
+// takes no initialization or allocation.
+struct BuiltinLexicon {
+  WordList words;
+  const uint8_t * columns[word_length];
+  const uint32_t * masks;
+};
+
+// from wordle_words.cpp and wordle_answers.cpp
+extern const BuiltinLexicon builtin_words;
+extern const BuiltinLexicon builtin_answers;
+
+namespace builtin {
+
+  template < size_t N >
+  struct Columns {
+    uint8_t letters[word_length][N];
+    uint32_t masks[N];
+  };
+
+  template < size_t N >
+  constexpr Columns< N > make_columns(const Word (&words)[N]) {
+    Columns< N > c{};
+    for (size_t i = 0; i < N; i++) {
+      for (int j = 0; j < word_length; j++) c.letters[j][i] = uint8_t(words[i][j]);
+      c.masks[i] = letter_mask(words[i]);
+    }
+    return c;
+  }
+
+  template < size_t N >
+  constexpr BuiltinLexicon make_lexicon(const Word (&words)[N], const Columns< N > & c) {
+    return BuiltinLexicon{WordList(words, N), {c.letters[0], c.letters[1], c.letters[2], c.letters[3], c.letters[4]}, c.masks};
+  }
+
+  // Word's constructor already insists on exactly 5 characters, so this
+  // catches anything else that isn't a lowercase word, like "Cigar" or "ci ar"
+  template < size_t N >
+  constexpr bool all_lowercase(const Word (&words)[N]) {
+    for (size_t i = 0; i < N; i++) {
+      for (int j = 0; j < word_length; j++) {
+        if (words[i][j] < 'a' || words[i][j] > 'z') return false;
+      }
+    }
+    return true;
+  }
+
+}
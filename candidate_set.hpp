@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+// A set of indices into a lexicon (e.g. all_words or all_answers), stored as a
+// fixed-size bitset so that filtering, counting and intersecting candidates
+// never touches the heap. Only the first (n + 63) / 64 blocks are ever used.
+struct CandidateSet {
+  static constexpr uint32_t capacity = 16384;
+  static constexpr uint32_t num_blocks = capacity / 64;
+
+  // visits the members in increasing order
+  struct iterator {
+    const uint64_t * blocks;
+    uint32_t block;
+    uint32_t end_block;
+    uint64_t remaining;
+
+    int operator*() const { return int(block * 64 + __builtin_ctzll(remaining)); }
+
+    iterator & operator++() {
+      remaining &= remaining - 1;
+      advance();
+      return *this;
+    }
+
+    // skip ahead to the next nonempty block, stopping at end_block
+    void advance() {
+      while (remaining == 0) {
+        if (++block >= end_block) { block = end_block; return; }
+        remaining = blocks[block];
+      }
+    }
+
+    bool operator!=(const iterator & other) const {
+      return block != other.block || remaining != other.remaining;
+    }
+  };
+
+  CandidateSet() : n{}, blocks{} {}
+
+  // the empty set, over a lexicon with n words
+  explicit CandidateSet(size_t n) : n(uint32_t(n)), blocks{} {
+    if (n > capacity) {
+      std::cout << "CandidateSet: lexicon of " << n << " words exceeds capacity of " << capacity << std::endl;
+      exit(1);
+    }
+  }
+
+  // every index in [0, n)
+  static CandidateSet all(size_t n) {
+    CandidateSet s(n);
+    for (uint32_t b = 0; b < n / 64; b++) s.blocks[b] = ~uint64_t(0);
+    if (n % 64) s.blocks[n / 64] = (uint64_t(1) << (n % 64)) - 1;
+    return s;
+  }
+
+  uint32_t active_blocks() const { return (n + 63) / 64; }
+
+  void insert(int i) { blocks[i / 64] |= uint64_t(1) << (i % 64); }
+  void erase(int i) { blocks[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+  bool contains(int i) const { return (blocks[i / 64] >> (i % 64)) & 1; }
+
+  size_t size() const {
+    size_t count = 0;
+    for (uint32_t b = 0; b < active_blocks(); b++) count += __builtin_popcountll(blocks[b]);
+    return count;
+  }
+
+  bool empty() const {
+    for (uint32_t b = 0; b < active_blocks(); b++) if (blocks[b]) return false;
+    return true;
+  }
+
+  iterator begin() const {
+    if (active_blocks() == 0) return end();
+    iterator it{blocks.data(), 0, active_blocks(), blocks[0]};
+    it.advance();
+    return it;
+  }
+
+  iterator end() const { return iterator{blocks.data(), active_blocks(), active_blocks(), 0}; }
+
+  // the smallest member, or -1 if there isn't one
+  int first() const { return empty() ? -1 : *begin(); }
+
+  CandidateSet & operator&=(const CandidateSet & other) {
+    for (uint32_t b = 0; b < active_blocks(); b++) blocks[b] &= other.blocks[b];
+    return *this;
+  }
+
+  CandidateSet & operator|=(const CandidateSet & other) {
+    for (uint32_t b = 0; b < active_blocks(); b++) blocks[b] |= other.blocks[b];
+    return *this;
+  }
+
+  bool operator==(const CandidateSet & other) const {
+    if (n != other.n) return false;
+    for (uint32_t b = 0; b < active_blocks(); b++) if (blocks[b] != other.blocks[b]) return false;
+    return true;
+  }
+
+  uint32_t n;
+  alignas(64) std::array< uint64_t, num_blocks > blocks;
+};
+
+// a well-mixed hash of the members; different seeds give independent hashes
+inline uint64_t hash(const CandidateSet & s, uint64_t seed = 0) {
+  uint64_t h = seed ^ (uint64_t(s.n) * 0x9E3779B97F4A7C15ull);
+  for (uint32_t b = 0; b < s.active_blocks(); b++) {
+    h = (h ^ s.blocks[b]) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 31;
+  }
+  h *= 0x94D049BB133111EBull;
+  return h ^ (h >> 29);
+}
+
+inline CandidateSet operator&(CandidateSet a, const CandidateSet & b) { return a &= b; }
+inline CandidateSet operator|(CandidateSet a, const CandidateSet & b) { return a |= b; }
@@ -0,0 +1,125 @@
+#include "decision_tree.hpp"
+#include "profiler.hpp"
+#include "lexicon_file.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+bool write_tree(const DecisionTree & tree, const std::string & filename) {
+  PROFILE_ZONE("write tree");
+
+  // renumber the nodes breadth-first, so siblings end up next to each other
+  std::vector< int > order;
+  std::vector< uint32_t > position(tree.nodes.size());
+  if (!tree.nodes.empty()) order.push_back(0);
+  for (size_t i = 0; i < order.size(); i++) {
+    position[order[i]] = uint32_t(i);
+    for (auto [pattern, child] : tree.nodes[order[i]].children) order.push_back(child);
+  }
+
+  std::vector< tree_file::Node > nodes;
+  std::vector< tree_file::Edge > edges;
+  for (auto i : order) {
+    auto children = tree.nodes[i].children;
+    std::sort(children.begin(), children.end());
+
+    nodes.push_back(tree_file::Node{uint16_t(tree.nodes[i].guess), uint16_t(children.size()), uint32_t(edges.size())});
+    for (auto [pattern, child] : children) {
+      edges.push_back(tree_file::Edge{position[child], pattern, {}});
+    }
+  }
+
+  tree_file::Header header{};
+  std::memcpy(header.magic, tree_file::magic, sizeof(header.magic));
+  header.version = tree_file::version;
+  header.num_words = uint32_t(all_words.size());
+  header.num_nodes = uint32_t(nodes.size());
+  header.num_edges = uint32_t(edges.size());
+  header.total_guesses = uint32_t(tree.total_guesses);
+  header.max_guesses = uint32_t(tree.max_guesses);
+  header.lexicon = lexicon_checksum();
+
+  std::ofstream outfile(filename, std::ios::binary);
+  outfile.write((const char *)&header, sizeof(header));
+  outfile.write((const char *)nodes.data(), std::streamsize(nodes.size() * sizeof(tree_file::Node)));
+  outfile.write((const char *)edges.data(), std::streamsize(edges.size() * sizeof(tree_file::Edge)));
+  return bool(outfile);
+
+}
+
+MappedTree::MappedTree(const std::string & filename) {
+  PROFILE_ZONE("load tree");
+
+  auto fail = [&](const char * reason) {
+    std::cout << filename << ": " << reason << std::endl;
+    exit(1);
+  };
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) fail("could not open file");
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) fail("could not stat file");
+  length = size_t(info.st_size);
+  if (length < sizeof(tree_file::Header)) fail("not a decision tree file");
+
+  data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) fail("could not map file");
+
+  header = (const tree_file::Header *)data;
+  nodes = (const tree_file::Node *)(header + 1);
+  edges = (const tree_file::Edge *)(nodes + header->num_nodes);
+
+  if (std::memcmp(header->magic, tree_file::magic, sizeof(header->magic)) != 0) {
+    fail("not a decision tree file");
+  }
+  if (header->version != tree_file::version) fail("unsupported decision tree version");
+  if (header->num_words != all_words.size() || header->lexicon != lexicon_checksum()) {
+    fail("tree was built for different word lists");
+  }
+  if (header->num_nodes == 0) fail("empty decision tree");
+
+  size_t expected = sizeof(tree_file::Header) +
+                    size_t(header->num_nodes) * sizeof(tree_file::Node) +
+                    size_t(header->num_edges) * sizeof(tree_file::Edge);
+  if (length != expected) fail("truncated decision tree file");
+
+  // every guess and every edge must point inside the file, and each node's
+  // edges must be sorted for next() to find them
+  for (uint32_t n = 0; n < header->num_nodes; n++) {
+    const tree_file::Node & node = nodes[n];
+    if (node.guess >= all_words.size()) fail("damaged decision tree: guess out of range");
+    if (uint64_t(node.first_edge) + node.num_edges > header->num_edges) {
+      fail("damaged decision tree: edges out of range");
+    }
+    for (uint32_t e = node.first_edge; e < node.first_edge + node.num_edges; e++) {
+      if (edges[e].node >= header->num_nodes) fail("damaged decision tree: edge to a missing node");
+      if (edges[e].pattern >= all_green) fail("damaged decision tree: bad pattern");
+      if (e > node.first_edge && edges[e].pattern <= edges[e - 1].pattern) {
+        fail("damaged decision tree: edges out of order");
+      }
+    }
+  }
+
+}
+
+MappedTree::~MappedTree() {
+  munmap(data, length);
+}
+
+MappedTree::Node MappedTree::next(Node n, uint8_t pattern) const {
+  const tree_file::Edge * begin = edges + nodes[n].first_edge;
+  const tree_file::Edge * end = begin + nodes[n].num_edges;
+  auto it = std::lower_bound(begin, end, pattern, [](const tree_file::Edge & e, uint8_t p) {
+    return e.pattern < p;
+  });
+  return (it != end && it->pattern == pattern) ? it->node : none;
+}
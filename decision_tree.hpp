@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "wordle_tools.hpp"
+
+// One node per guess: the guess to make, and the node to go to next for each
+// feedback pattern that isn't all green. The root is nodes[0].
+struct DecisionTree {
+  struct Node {
+    int guess; // index into all_words
+    std::vector< std::pair< uint8_t, int > > children;
+  };
+
+  std::vector< Node > nodes;
+
+  // the cost of the tree, under each of the two measures
+  int total_guesses;
+  int max_guesses;
+};
+
+// On disk, a tree is a header followed by two flat arrays: the nodes in
+// breadth-first order, then the edges. Each node's edges are contiguous and
+// sorted by pattern, so following one is a binary search over at most 242
+// entries. Everything is fixed-size and little-endian, so the file is used
+// as-is straight out of mmap().
+namespace tree_file {
+
+  constexpr char magic[8] = {'W', 'R', 'D', 'L', 'T', 'R', 'E', 'E'};
+  constexpr uint32_t version = 2;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_words;    // size of all_words the guesses index into
+    uint32_t num_nodes;
+    uint32_t num_edges;
+    uint32_t total_guesses;
+    uint32_t max_guesses;
+    uint64_t lexicon;      // lexicon_checksum() of the lists it was built with
+  };
+
+  struct Node {
+    uint16_t guess;
+    uint16_t num_edges;
+    uint32_t first_edge;
+  };
+
+  struct Edge {
+    uint32_t node;
+    uint8_t pattern;
+    uint8_t padding[3];
+  };
+
+  static_assert(sizeof(Header) == 40 && sizeof(Node) == 8 && sizeof(Edge) == 8);
+
+}
+
+// returns false if the file couldn't be written
+bool write_tree(const DecisionTree & tree, const std::string & filename);
+
+// A tree file mapped into memory. Opening it checks every node and edge, so
+// walking it can trust the file and never allocates.
+class MappedTree {
+ public:
+  using Node = uint32_t;
+  static constexpr Node root = 0;
+  static constexpr Node none = ~Node(0);
+
+  // exits with a message if the file is missing or malformed
+  explicit MappedTree(const std::string & filename);
+  ~MappedTree();
+
+  MappedTree(const MappedTree &) = delete;
+  MappedTree & operator=(const MappedTree &) = delete;
+
+  // the guess to make at node n, as an index into all_words
+  int guess(Node n) const { return nodes[n].guess; }
+
+  // where to go after seeing `pattern` at node n, or none if
+  // no answer the tree was built for gives that pattern
+  Node next(Node n, uint8_t pattern) const;
+
+  size_t size() const { return header->num_nodes; }
+  int total_guesses() const { return int(header->total_guesses); }
+  int max_guesses() const { return int(header->max_guesses); }
+
+ private:
+  void * data;
+  size_t length;
+
+  const tree_file::Header * header;
+  const tree_file::Node * nodes;
+  const tree_file::Edge * edges;
+};
@@ -1,28 +1,75 @@
 #include <array>
+#include <string>
+#include <cstdlib>
 #include <vector>
 #include <iostream>
 #include <algorithm>
 
 #include "wordle_tools.hpp"
+#include "game_server.hpp"
+#include "profiler.hpp"
 
 bool hard_mode = true;
 
+void usage() {
+  std::cout << "usage: wordle" << std::endl;
+  std::cout << "       wordle --serve (--port N | --socket PATH) [--max-sessions N]" << std::endl;
+  exit(1);
+}
+
 int main(int argc, char * argv[]) {
 
+  bool serve = false;
+  int port = 0;
+  std::string socket_path;
+  int max_sessions = 4096;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--serve") {
+      serve = true;
+    } else if (arg == "--port") {
+      if (i + 1 == argc) usage();
+      port = std::atoi(argv[++i]);
+      if (port <= 0 || port > 65535) usage();
+    } else if (arg == "--socket") {
+      if (i + 1 == argc) usage();
+      socket_path = argv[++i];
+    } else if (arg == "--max-sessions") {
+      if (i + 1 == argc) usage();
+      max_sessions = std::atoi(argv[++i]);
+      if (max_sessions <= 0) usage();
+    } else {
+      usage();
+    }
+  }
+
+  if (serve) {
+    if ((port > 0) == !socket_path.empty()) usage();
+    int listener = (port > 0) ? GameServer::listen_tcp(port) : GameServer::listen_unix(socket_path);
+    GameServer server(listener, size_t(max_sessions));
+    server.run();
+    return 0;
+  }
+  if (port > 0 || !socket_path.empty()) usage();
+
   Word answer = random(all_answers);
 
   int num_guesses = 0;
 
   while (num_guesses < 6) {
     std::string guess;
-    std::getline(std::cin, guess);
-    delete_line();
+    {
+      PROFILE_ZONE("read guess");
+      std::getline(std::cin, guess);
+      delete_line();
+    }
     if (guess.size() == word_length) {
+      PROFILE_ZONE("game turn");
       auto clues = get_clues(answer, guess);
       print(clues, guess);
       num_guesses++;
 
-      if (clues == std::array{GREEN, GREEN, GREEN, GREEN, GREEN}) break;
+      if (encode(clues) == all_green) break;
     }
   }
 
@@ -0,0 +1,366 @@
+#include "game_server.hpp"
+
+#include "wordle_tools.hpp"
+#include "word_index.hpp"
+#include "profiler.hpp"
+#include "stop_signal.hpp"
+
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace {
+
+  // the epoll tags for the listening socket and the stop signal, as opposed
+  // to a session's slot
+  constexpr uint32_t listener_tag = ~uint32_t(0);
+  constexpr uint32_t stop_tag = ~uint32_t(1);
+
+  constexpr uint32_t max_events = 256;
+
+  void fail(const char * what) {
+    std::cerr << what << ": " << std::strerror(errno) << std::endl;
+    exit(1);
+  }
+
+  // descriptors kept back from sessions: stdio, the listener, epoll, the
+  // reserve descriptor, and some slack for anything else the process opens
+  constexpr rlim_t other_descriptors = 16;
+
+  // as many of max_sessions as the limit on open files allows, after raising
+  // that limit as far as it goes
+  size_t session_limit(size_t max_sessions) {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) fail("getrlimit");
+    if (limit.rlim_cur < limit.rlim_max) {
+      limit.rlim_cur = limit.rlim_max;
+      if (setrlimit(RLIMIT_NOFILE, &limit) != 0) getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (limit.rlim_cur == RLIM_INFINITY) return max_sessions;
+    size_t allowed = (limit.rlim_cur > other_descriptors) ? size_t(limit.rlim_cur - other_descriptors) : 1;
+    if (max_sessions > allowed) {
+      std::cerr << "only " << allowed << " sessions fit in the limit of " << limit.rlim_cur << " open files" << std::endl;
+      return allowed;
+    }
+    return max_sessions;
+  }
+
+  // appends to a fixed-size buffer, which the caller has made sure has room
+  struct Writer {
+    char * out;
+    void put(char c) { *out++ = c; }
+    void put(const char * s) { while (*s) *out++ = *s++; }
+    void put(Word w) { for (auto c : w.data) *out++ = c; }
+    void put(int n) { if (n >= 10) put(n / 10); *out++ = char('0' + n % 10); }
+  };
+
+}
+
+GameServer::GameServer(int listener, size_t max_sessions) :
+  listener(listener), accepting(true), sessions(session_limit(max_sessions)),
+  random_answers(uint32_t(std::chrono::system_clock::now().time_since_epoch().count())) {
+
+  // the index is sorted now rather than on the first guess
+  words_index();
+
+  for (auto & s : sessions) s.fd = -1;
+  free_slots.reserve(sessions.size());
+  for (size_t i = sessions.size(); i > 0; i--) free_slots.push_back(uint32_t(i - 1));
+
+  reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (reserve_fd < 0) fail("open /dev/null");
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0) fail("epoll_create1");
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u32 = listener_tag;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listener, &event) != 0) fail("epoll_ctl");
+
+  event.data.u32 = stop_tag;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_signal(), &event) != 0) fail("epoll_ctl");
+}
+
+GameServer::~GameServer() {
+  for (auto & s : sessions) if (s.fd >= 0) close(s.fd);
+  if (reserve_fd >= 0) close(reserve_fd);
+  close(epoll_fd);
+}
+
+int GameServer::listen_tcp(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) fail("socket");
+  int yes = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(uint16_t(port));
+  if (bind(fd, (sockaddr *)&address, sizeof(address)) != 0) fail("bind");
+  if (listen(fd, SOMAXCONN) != 0) fail("listen");
+  std::cerr << "listening on 127.0.0.1:" << port << std::endl;
+  return fd;
+}
+
+int GameServer::listen_unix(const std::string & path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "socket path is too long: " << path << std::endl;
+    exit(1);
+  }
+  std::strcpy(address.sun_path, path.c_str());
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) fail("socket");
+  unlink(path.c_str());
+  if (bind(fd, (sockaddr *)&address, sizeof(address)) != 0) fail("bind");
+  if (listen(fd, SOMAXCONN) != 0) fail("listen");
+  std::cerr << "listening on " << path << std::endl;
+  return fd;
+}
+
+void GameServer::run() {
+  epoll_event events[max_events];
+  while (true) {
+    int n = epoll_wait(epoll_fd, events, max_events, -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      fail("epoll_wait");
+    }
+    PROFILE_ZONE("server events");
+    for (int i = 0; i < n; i++) {
+      if (events[i].data.u32 == stop_tag) {
+        return;
+      } else if (events[i].data.u32 == listener_tag) {
+        accept_all();
+      } else {
+        on_event(events[i].data.u32, events[i].events);
+      }
+    }
+  }
+}
+
+void GameServer::accept_all() {
+  static const char full[] = "err server full\n";
+  while (true) {
+    int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+
+      // Out of descriptors, the pending connection stays queued, and the
+      // listener would stay readable and wake us again at once. So the
+      // reserve descriptor is given up to accept it and turn it away.
+      if ((errno == EMFILE || errno == ENFILE) && reserve_fd >= 0) {
+        close(reserve_fd);
+        fd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+          send(fd, full, sizeof(full) - 1, MSG_NOSIGNAL);
+          close(fd);
+        }
+        reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) continue;
+      }
+
+      // still out of descriptors with no reserve: stop watching the listener
+      // until a session closes and frees one
+      if (errno == EMFILE || errno == ENFILE) watch_listener(false);
+
+      // otherwise there's nothing left to accept until the next event
+      return;
+    }
+    if (free_slots.empty()) {
+      send(fd, full, sizeof(full) - 1, MSG_NOSIGNAL);
+      close(fd);
+      continue;
+    }
+
+    uint32_t slot = free_slots.back();
+    free_slots.pop_back();
+    Session & s = sessions[slot];
+    s.fd = fd;
+    s.discarding = false;
+    s.events = 0;
+    s.input_length = 0;
+    s.output_length = 0;
+    new_game(s);
+    watch(slot, s);
+  }
+}
+
+void GameServer::new_game(Session & s) {
+  s.answer = uint16_t(std::uniform_int_distribution< uint32_t >(0, uint32_t(all_answers.size() - 1))(random_answers));
+  s.num_guesses = 0;
+  s.status = PLAYING;
+}
+
+void GameServer::on_event(uint32_t slot, uint32_t events) {
+  Session & s = sessions[slot];
+  if (s.fd < 0) return; // closed earlier in this batch
+
+  // with a full buffer, the data (or the hangup) waits until it has been processed
+  size_t room = sizeof(s.input) - s.input_length;
+  if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && room > 0) {
+    ssize_t n = read(s.fd, s.input + s.input_length, room);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+      close_session(s);
+      free_slots.push_back(slot);
+      return;
+    }
+    if (n > 0) s.input_length += uint16_t(n);
+  }
+
+  // lines already read may be waiting on room for their responses, so keep
+  // going for as long as the socket takes them and there are lines left
+  while (true) {
+    uint16_t unprocessed = s.input_length;
+    process(s);
+    if (s.fd < 0 || !flush(s)) {
+      if (s.fd >= 0) close_session(s);
+      free_slots.push_back(slot);
+      return;
+    }
+    if (s.output_length > 0 || s.input_length == unprocessed) break;
+  }
+  watch(slot, s);
+}
+
+void GameServer::process(Session & s) {
+  size_t begin = 0;
+  while (s.fd >= 0 && sizeof(s.output) - s.output_length >= max_response) {
+    char * newline = (char *)std::memchr(s.input + begin, '\n', s.input_length - begin);
+    if (!newline) break;
+    size_t end = size_t(newline - s.input);
+    if (s.discarding) {
+      s.discarding = false;
+    } else {
+      size_t length = end - begin;
+      if (length > 0 && s.input[end - 1] == '\r') length--;
+      respond(s, s.input + begin, length);
+    }
+    begin = end + 1;
+  }
+  if (s.fd < 0) return;
+
+  std::memmove(s.input, s.input + begin, s.input_length - begin);
+  s.input_length -= uint16_t(begin);
+
+  // a full buffer without a newline can't be a guess, so
+  // drop it and everything else up to the end of the line
+  if (s.input_length == sizeof(s.input) && sizeof(s.output) - s.output_length >= max_response) {
+    if (!s.discarding) {
+      Writer w{s.output + s.output_length};
+      w.put("err line too long\n");
+      s.output_length = uint16_t(w.out - s.output);
+    }
+    s.discarding = true;
+    s.input_length = 0;
+  }
+}
+
+void GameServer::respond(Session & s, const char * line, size_t length) {
+  PROFILE_ZONE("server request");
+  Writer w{s.output + s.output_length};
+
+  if (length == 4 && std::memcmp(line, "quit", 4) == 0) {
+    flush(s);
+    close_session(s);
+    return;
+  }
+
+  if (length == 3 && std::memcmp(line, "new", 3) == 0) {
+    new_game(s);
+    w.put("ok\n");
+  } else if (s.status != PLAYING) {
+    w.put("err game over\n");
+  } else {
+    int guess = -1;
+    if (length == word_length) {
+      Word word;
+      std::memcpy(word.data, line, word_length);
+      guess = words_index().find(word);
+    }
+    if (guess < 0) {
+      w.put("err not a valid guess\n");
+    } else {
+      Word answer = all_answers[s.answer];
+      uint8_t pattern = get_pattern(answer, all_words[guess]);
+      s.guesses[s.num_guesses] = uint16_t(guess);
+      s.patterns[s.num_guesses] = pattern;
+      s.num_guesses++;
+
+      w.put("ok ");
+      for (auto clue : all_clues[pattern]) w.put("byg"[clue]);
+      w.put(' ');
+      w.put(int(s.num_guesses));
+      if (pattern == all_green) {
+        s.status = WON;
+        w.put(" won");
+      } else if (s.num_guesses == max_guesses) {
+        s.status = LOST;
+        w.put(" lost ");
+        w.put(answer);
+      }
+      w.put('\n');
+    }
+  }
+
+  s.output_length = uint16_t(w.out - s.output);
+}
+
+bool GameServer::flush(Session & s) {
+  size_t sent = 0;
+  while (sent < s.output_length) {
+    ssize_t n = send(s.fd, s.output + sent, s.output_length - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && errno == EAGAIN) break;
+    if (n <= 0) return false;
+    sent += size_t(n);
+  }
+  std::memmove(s.output, s.output + sent, s.output_length - sent);
+  s.output_length -= uint16_t(sent);
+  return true;
+}
+
+// level-triggered: reads stop while there's no room for the responses,
+// and writability only matters while responses are queued
+void GameServer::watch(uint32_t slot, Session & s) {
+  uint32_t wanted = 0;
+  if (sizeof(s.output) - s.output_length >= max_response) wanted |= EPOLLIN;
+  if (s.output_length > 0) wanted |= EPOLLOUT;
+  if (wanted == s.events) return;
+
+  epoll_event event{};
+  event.events = wanted;
+  event.data.u32 = slot;
+  int op = (s.events == 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+  if (epoll_ctl(epoll_fd, op, s.fd, &event) != 0) fail("epoll_ctl");
+  s.events = wanted;
+}
+
+void GameServer::close_session(Session & s) {
+  close(s.fd); // which also removes it from the epoll set
+  s.fd = -1;
+  if (!accepting) {
+    if (reserve_fd < 0) reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    watch_listener(true);
+  }
+}
+
+void GameServer::watch_listener(bool on) {
+  epoll_event event{};
+  event.events = on ? uint32_t(EPOLLIN) : 0u;
+  event.data.u32 = listener_tag;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, listener, &event) != 0) fail("epoll_ctl");
+  accepting = on;
+}
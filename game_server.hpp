@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "word.hpp"
+
+// Many games of wordle at once, one per connection, multiplexed on a single
+// epoll loop. Every session lives in a fixed-size slot allocated up front, so
+// serving a connection never allocates, whatever its clients send.
+//
+// A game starts as soon as a client connects. Each line it sends is a guess,
+// answered with "ok", its feedback (five of g, y or b for green, yellow and
+// gray) and the number of guesses so far, plus "won", or "lost" and the
+// answer, once the game is over, e.g. "ok bgybb 2" or "ok ggggg 4 won".
+// Guesses have to be in the lexicon, and invalid ones get "err" and a message
+// without using up a turn, as with SolverDaemon. "new" starts another game
+// (answered with "ok") and "quit" hangs up.
+class GameServer {
+ public:
+  static constexpr int max_guesses = 6;
+
+  // serves connections to listener (a listening socket) with at most
+  // max_sessions of them open at once, or fewer if that many wouldn't fit in
+  // the limit on open files
+  GameServer(int listener, size_t max_sessions);
+  ~GameServer();
+
+  // the event loop, which returns once the process gets SIGINT or SIGTERM
+  void run();
+
+  // listening sockets, or exit with a message if they can't be set up
+  static int listen_tcp(int port);        // on 127.0.0.1
+  static int listen_unix(const std::string & path);
+
+ private:
+  enum Status : uint8_t { PLAYING, WON, LOST };
+
+  struct Session {
+    int fd;             // -1 for a free slot
+    uint16_t answer;    // index into all_answers
+    uint8_t num_guesses;
+    Status status;
+    uint16_t guesses[max_guesses];  // indices into all_words
+    uint8_t patterns[max_guesses];
+    bool discarding;    // skipping the rest of a line too long to be a guess
+    uint32_t events;    // what epoll is currently watching for
+    uint16_t input_length;
+    uint16_t output_length;
+    char input[64];
+    char output[128];
+  };
+
+  static_assert(sizeof(Session) <= 256, "sessions are meant to stay small");
+
+  // the longest line a response can take
+  static constexpr size_t max_response = 32;
+
+  void accept_all();
+  void on_event(uint32_t slot, uint32_t events);
+  void process(Session & s);
+  void respond(Session & s, const char * line, size_t length);
+  bool flush(Session & s);
+  void watch(uint32_t slot, Session & s);
+  void close_session(Session & s);
+  void watch_listener(bool on);
+  void new_game(Session & s);
+
+  int listener;
+  int epoll_fd;
+  int reserve_fd;     // kept open to give up when out of descriptors
+  bool accepting;     // whether epoll is watching the listener
+  std::vector< Session > sessions;
+  std::vector< uint32_t > free_slots;
+  std::mt19937 random_answers;
+};
@@ -0,0 +1,185 @@
+#include "guess_cache.hpp"
+
+#include "lexicon_file.hpp"
+#include "profiler.hpp"
+
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+  // a saved cache is a header and then one record per entry
+  constexpr char magic[8] = {'W', 'R', 'D', 'L', 'C', 'A', 'C', 'H'};
+  constexpr uint32_t version = 2;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_entries;
+    uint64_t lexicon;   // lexicon_checksum() of the lists it was made with
+    uint64_t reserved;
+  };
+
+  struct Record {
+    uint64_t fingerprint[2];
+    uint32_t objective;
+    int32_t guess;
+  };
+
+  static_assert(sizeof(Header) == 32 && sizeof(Record) == 24);
+
+}
+
+GuessCache::GuessCache(size_t capacity) :
+  shard_capacity(std::max< size_t >(1, capacity / num_shards)), hits(0), misses(0), evictions(0) {}
+
+GuessCache::Key GuessCache::key(const CandidateSet & candidates, Objective objective) {
+  return Key{{hash(candidates, 0), hash(candidates, 0x5851F42D4C957F2Dull)}, uint32_t(objective)};
+}
+
+int GuessCache::find(const CandidateSet & candidates, Objective objective) {
+  Key k = key(candidates, objective);
+  Shard & shard = shards[k.fingerprint[1] % num_shards];
+  std::lock_guard< std::mutex > lock(shard.mutex);
+  auto it = shard.entries.find(k);
+  if (it == shard.entries.end()) {
+    misses++;
+    return -1;
+  }
+  hits++;
+  shard.order.splice(shard.order.begin(), shard.order, it->second);
+  return it->second->guess;
+}
+
+void GuessCache::insert(const CandidateSet & candidates, Objective objective, int guess) {
+  insert(key(candidates, objective), guess);
+}
+
+void GuessCache::insert(const Key & k, int guess) {
+  Shard & shard = shards[k.fingerprint[1] % num_shards];
+  std::lock_guard< std::mutex > lock(shard.mutex);
+  auto it = shard.entries.find(k);
+  if (it != shard.entries.end()) {
+    it->second->guess = guess;
+    shard.order.splice(shard.order.begin(), shard.order, it->second);
+    return;
+  }
+
+  if (shard.entries.size() >= shard_capacity) {
+    shard.entries.erase(shard.order.back().key);
+    shard.order.pop_back();
+    evictions++;
+  }
+  shard.order.push_front(Entry{k, guess});
+  shard.entries.emplace(k, shard.order.begin());
+}
+
+GuessCacheStats GuessCache::stats() const {
+  GuessCacheStats s{hits, misses, evictions, 0};
+  for (auto & shard : shards) {
+    std::lock_guard< std::mutex > lock(shard.mutex);
+    s.size += shard.entries.size();
+  }
+  return s;
+}
+
+bool GuessCache::save(const std::string & filename) const {
+  PROFILE_ZONE("save guess cache");
+
+  // interleaving the shards keeps the whole file roughly in order of use
+  std::vector< Record > records;
+  std::vector< std::list< Entry > > copies(num_shards);
+  for (int i = 0; i < num_shards; i++) {
+    std::lock_guard< std::mutex > lock(shards[i].mutex);
+    copies[i] = shards[i].order;
+  }
+  for (bool more = true; more; ) {
+    more = false;
+    for (auto & c : copies) {
+      if (c.empty()) continue;
+      const Key & k = c.front().key;
+      records.push_back(Record{{k.fingerprint[0], k.fingerprint[1]}, k.objective, c.front().guess});
+      c.pop_front();
+      more = true;
+    }
+  }
+
+  Header header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.num_entries = uint32_t(records.size());
+  header.lexicon = lexicon_checksum();
+
+  std::ofstream outfile(filename, std::ios::binary);
+  outfile.write((const char *)&header, sizeof(header));
+  outfile.write((const char *)records.data(), std::streamsize(records.size() * sizeof(Record)));
+  return bool(outfile);
+}
+
+bool GuessCache::load(const std::string & filename) {
+  PROFILE_ZONE("load guess cache");
+
+  std::ifstream infile(filename, std::ios::binary);
+  Header header{};
+  if (!infile.read((char *)&header, sizeof(header))) return false;
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version) return false;
+  if (header.lexicon != lexicon_checksum()) return false;
+
+  // the entries must all be there before any room is made for them
+  std::streampos start = infile.tellg();
+  infile.seekg(0, std::ios::end);
+  std::streamoff remaining = infile.tellg() - start;
+  infile.seekg(start);
+  if (!infile || remaining < std::streamoff(header.num_entries) * std::streamoff(sizeof(Record))) return false;
+
+  std::vector< Record > records(header.num_entries);
+  if (!infile.read((char *)records.data(), std::streamsize(records.size() * sizeof(Record)))) return false;
+  for (auto & r : records) {
+    if (r.guess < 0 || size_t(r.guess) >= all_words.size() || r.objective > ENTROPY) return false;
+  }
+
+  // least recent first, so the most recent end up at the front
+  for (auto it = records.rbegin(); it != records.rend(); ++it) {
+    insert(Key{{it->fingerprint[0], it->fingerprint[1]}, it->objective}, it->guess);
+  }
+  return true;
+}
+
+namespace {
+
+  // from WORDLE_GUESS_CACHE, if it is set
+  std::string cache_file;
+
+  void save_cache() {
+    GuessCache & cache = guess_cache();
+    if (!cache.save(cache_file)) std::cerr << "WORDLE_GUESS_CACHE: could not write " << cache_file << std::endl;
+  }
+
+}
+
+GuessCache & guess_cache() {
+  static GuessCache cache(size_t(1) << 16);
+  static const bool loaded = [](){
+    if (const char * filename = std::getenv("WORDLE_GUESS_CACHE")) {
+      cache_file = filename;
+      cache.load(cache_file);
+      std::atexit(save_cache);
+    }
+    return true;
+  }();
+  (void)loaded;
+  return cache;
+}
+
+int best_guess(const CandidateSet & possible_answers, Objective objective) {
+  GuessCache & cache = guess_cache();
+  int guess = cache.find(possible_answers, objective);
+  if (guess < 0) {
+    guess = best_guess_brute_force(possible_answers, objective);
+    cache.insert(possible_answers, objective, guess);
+  }
+  return guess;
+}
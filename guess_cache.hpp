@@ -0,0 +1,90 @@
+#pragma once
+
+#include <list>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "wordle_tools.hpp"
+
+struct GuessCacheStats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  size_t size;
+
+  double hit_rate() const { return (hits + misses) ? double(hits) / (hits + misses) : 0.0; }
+};
+
+// Remembers best_guess_brute_force() results, keyed by the set of candidates
+// itself rather than by the guesses that led to it, since many different
+// games reach the same set. Sets are identified by two independent 64-bit
+// hashes, like the tree search's transposition table.
+//
+// It holds at most `capacity` entries, split into shards with a lock each so
+// that threads rarely wait on one another, and each shard evicts its own
+// least recently used entry when it fills up. It can be saved to a file and
+// loaded again, for which entries are tied to the word lists in use: a file
+// saved with different lists is ignored.
+class GuessCache {
+ public:
+  explicit GuessCache(size_t capacity);
+
+  // the cached guess for candidates, or -1 if there isn't one
+  int find(const CandidateSet & candidates, Objective objective);
+  void insert(const CandidateSet & candidates, Objective objective, int guess);
+
+  GuessCacheStats stats() const;
+
+  // most recently used first, so that loading into a smaller cache keeps
+  // the entries most worth keeping. Both return false on failure, and load()
+  // adds nothing from a file that is missing, damaged or for other word lists.
+  bool save(const std::string & filename) const;
+  bool load(const std::string & filename);
+
+ private:
+  struct Key {
+    uint64_t fingerprint[2];
+    uint32_t objective;
+    bool operator==(const Key & other) const {
+      return fingerprint[0] == other.fingerprint[0] && fingerprint[1] == other.fingerprint[1] && objective == other.objective;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key & k) const { return size_t(k.fingerprint[0] ^ k.objective); }
+  };
+
+  struct Entry {
+    Key key;
+    int guess;
+  };
+
+  static Key key(const CandidateSet & candidates, Objective objective);
+  void insert(const Key & k, int guess);
+
+  // each shard's entries in order of use, most recent first
+  struct Shard {
+    mutable std::mutex mutex;
+    std::list< Entry > order;
+    std::unordered_map< Key, std::list< Entry >::iterator, KeyHash > entries;
+  };
+  static constexpr int num_shards = 16;
+  std::array< Shard, num_shards > shards;
+  size_t shard_capacity;
+
+  std::atomic< uint64_t > hits;
+  std::atomic< uint64_t > misses;
+  std::atomic< uint64_t > evictions;
+};
+
+// The cache used by best_guess(), with room for 64Ki sets. If the
+// environment variable WORDLE_GUESS_CACHE names a file, it is loaded from
+// there on first use and saved back when the program exits.
+GuessCache & guess_cache();
+
+// best_guess_brute_force(), through guess_cache()
+int best_guess(const CandidateSet & possible_answers, Objective objective = WORST_CASE);
@@ -0,0 +1,54 @@
+#pragma once
+
+// internal to the kernels: the instruction-set specific implementations
+// behind the functions in kernels.hpp, and the tables they share
+
+#include <cstdint>
+
+#include "wordle_tools.hpp"
+
+// The variants only ever see whole blocks, so n is always a multiple of
+// 64 here. kernels.cpp takes care of padding the last partial block.
+struct Kernels {
+  const char * name;
+  bool (*supported)();
+  void (*pattern_codes)(Word guess, const uint8_t * const columns[word_length], size_t n, uint8_t * out);
+  void (*consistent)(const State & s, const uint8_t * const columns[word_length], size_t n, uint64_t * bits);
+  void (*letter_masks)(const uint8_t * const columns[word_length], size_t n, uint32_t * out);
+};
+
+extern const Kernels scalar_kernels;
+
+#if defined(__x86_64__) || defined(__i386__)
+#define WORDLE_X86
+extern const Kernels sse42_kernels;
+extern const Kernels avx2_kernels;
+extern const Kernels avx512_kernels;
+#endif
+
+// State::is_consistent_with(), rearranged into byte lookups: letter c is
+// forbidden at position j if bit (c - 'a') is set in misplaced[j] | unused,
+// stored as two 16-entry tables so it can be looked up with a byte shuffle
+struct FilterTables {
+  alignas(16) uint8_t forbidden_lo[word_length][16];
+  alignas(16) uint8_t forbidden_hi[word_length][16];
+  char matched[word_length];
+  char used[26];
+  int num_used;
+};
+
+inline FilterTables filter_tables(const State & s) {
+  FilterTables t{};
+  for (int j = 0; j < word_length; j++) {
+    uint32_t forbidden = s.misplaced[j] | s.unused;
+    for (int c = 0; c < 16; c++) {
+      t.forbidden_lo[j][c] = (forbidden >> c) & 1 ? 0xFF : 0x00;
+      t.forbidden_hi[j][c] = (c + 16 < 26 && (forbidden >> (c + 16)) & 1) ? 0xFF : 0x00;
+    }
+    t.matched[j] = s.matched[j];
+  }
+  for (int c = 0; c < 26; c++) {
+    if (s.used & (uint32_t(1) << c)) t.used[t.num_used++] = char('a' + c);
+  }
+  return t;
+}
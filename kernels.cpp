@@ -0,0 +1,162 @@
+#include "kernels.hpp"
+#include "kernel_variants.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+static Word gather(const uint8_t * const columns[word_length], size_t i) {
+  Word w;
+  for (int j = 0; j < word_length; j++) w[j] = char(columns[j][i]);
+  return w;
+}
+
+static void pattern_codes_scalar(Word guess, const uint8_t * const columns[word_length], size_t n, uint8_t * out) {
+  for (size_t i = 0; i < n; i++) out[i] = get_pattern(gather(columns, i), guess);
+}
+
+static void consistent_scalar(const State & s, const uint8_t * const columns[word_length], size_t n, uint64_t * bits) {
+  for (size_t i = 0; i < n; i += 64) {
+    uint64_t block = 0;
+    for (size_t k = 0; k < 64; k++) {
+      block |= uint64_t(s.is_consistent_with(gather(columns, i + k))) << k;
+    }
+    bits[i / 64] = block;
+  }
+}
+
+static void letter_masks_scalar(const uint8_t * const columns[word_length], size_t n, uint32_t * out) {
+  for (size_t i = 0; i < n; i++) out[i] = letter_mask(gather(columns, i));
+}
+
+static bool always() { return true; }
+
+const Kernels scalar_kernels = {"scalar", always, pattern_codes_scalar, consistent_scalar, letter_masks_scalar};
+
+static const Kernels * const variants[] = {
+#if defined(WORDLE_X86)
+  &avx512_kernels, &avx2_kernels, &sse42_kernels,
+#endif
+  &scalar_kernels
+};
+
+static const Kernels & choose_kernels() {
+  if (const char * requested = std::getenv("WORDLE_KERNELS")) {
+    for (auto k : variants) {
+      if (std::strcmp(k->name, requested) == 0) {
+        if (k->supported()) return *k;
+        std::cerr << "WORDLE_KERNELS: " << requested << " is not supported on this host" << std::endl;
+        exit(1);
+      }
+    }
+    std::cerr << "WORDLE_KERNELS: unrecognized variant " << requested << std::endl;
+    exit(1);
+  }
+
+  // otherwise, the widest one the CPU supports
+  for (auto k : variants) {
+    if (k->supported()) return *k;
+  }
+  return scalar_kernels;
+}
+
+static const Kernels & kernels() {
+  static const Kernels & selected = choose_kernels();
+  return selected;
+}
+
+const char * kernel_name() { return kernels().name; }
+
+// The variants work on whole blocks of 64 words, so the remainder
+// gets copied into a block padded out with (ignored) copies of "aaaaa".
+constexpr size_t block = 64;
+
+struct PaddedBlock {
+  uint8_t letters[word_length][block];
+  const uint8_t * columns[word_length];
+
+  PaddedBlock(const uint8_t * const source[word_length], size_t begin, size_t n) {
+    for (int j = 0; j < word_length; j++) {
+      std::memset(letters[j], 'a', block);
+      std::memcpy(letters[j], source[j] + begin, n);
+      columns[j] = letters[j];
+    }
+  }
+};
+
+void pattern_codes(Word guess, const uint8_t * const columns[word_length], size_t n, uint8_t * out) {
+  size_t body = n - n % block;
+  if (body > 0) kernels().pattern_codes(guess, columns, body, out);
+  if (body < n) {
+    PaddedBlock tail(columns, body, n - body);
+    uint8_t codes[block];
+    kernels().pattern_codes(guess, tail.columns, block, codes);
+    std::memcpy(out + body, codes, n - body);
+  }
+}
+
+void consistent(const State & s, const uint8_t * const columns[word_length], size_t n, uint64_t * bits) {
+  size_t body = n - n % block;
+  if (body > 0) kernels().consistent(s, columns, body, bits);
+  if (body < n) {
+    PaddedBlock tail(columns, body, n - body);
+    uint64_t last;
+    kernels().consistent(s, tail.columns, block, &last);
+    bits[body / block] = last & ((uint64_t(1) << (n - body)) - 1);
+  }
+}
+
+void letter_masks(const uint8_t * const columns[word_length], size_t n, uint32_t * out) {
+  size_t body = n - n % block;
+  if (body > 0) kernels().letter_masks(columns, body, out);
+  if (body < n) {
+    PaddedBlock tail(columns, body, n - body);
+    uint32_t masks[block];
+    kernels().letter_masks(tail.columns, block, masks);
+    std::memcpy(out + body, masks, (n - body) * sizeof(uint32_t));
+  }
+}
+
+// For words stored one after another, transpose a few blocks
+// at a time into columns on the stack and run on those.
+struct TransposedBlocks {
+  static constexpr size_t capacity = 4 * block;
+  uint8_t letters[word_length][capacity];
+  const uint8_t * columns[word_length];
+
+  TransposedBlocks() {
+    for (int j = 0; j < word_length; j++) columns[j] = letters[j];
+  }
+
+  void load(const Word * words, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+      for (int j = 0; j < word_length; j++) letters[j][i] = uint8_t(words[i][j]);
+    }
+  }
+};
+
+void pattern_codes(Word guess, const Word * answers, size_t n, uint8_t * out) {
+  TransposedBlocks t;
+  for (size_t begin = 0; begin < n; begin += t.capacity) {
+    size_t count = std::min(t.capacity, n - begin);
+    t.load(answers + begin, count);
+    pattern_codes(guess, t.columns, count, out + begin);
+  }
+}
+
+void consistent(const State & s, const Word * words, size_t n, uint64_t * bits) {
+  TransposedBlocks t;
+  for (size_t begin = 0; begin < n; begin += t.capacity) {
+    size_t count = std::min(t.capacity, n - begin);
+    t.load(words + begin, count);
+    consistent(s, t.columns, count, bits + begin / block);
+  }
+}
+
+void letter_masks(const Word * words, size_t n, uint32_t * out) {
+  TransposedBlocks t;
+  for (size_t begin = 0; begin < n; begin += t.capacity) {
+    size_t count = std::min(t.capacity, n - begin);
+    t.load(words + begin, count);
+    letter_masks(t.columns, count, out + begin);
+  }
+}
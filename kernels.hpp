@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "wordle_tools.hpp"
+
+// Batch versions of the hot per-word routines. Each one comes in scalar,
+// SSE4.2, AVX2 and AVX-512 flavors, and the best one the host supports is
+// picked the first time any of them is called. Setting the environment
+// variable WORDLE_KERNELS to "scalar", "sse4.2", "avx2" or "avx512" pins a
+// particular variant instead (e.g. for timing comparisons).
+
+// out[i] = get_pattern(answers[i], guess) for i in [0, n)
+void pattern_codes(Word guess, const Word * answers, size_t n, uint8_t * out);
+
+// the same, for answers stored column-wise: columns[j][i] is letter j of answer i
+void pattern_codes(Word guess, const uint8_t * const columns[word_length], size_t n, uint8_t * out);
+
+// bit (i % 64) of bits[i / 64] is set when s.is_consistent_with(words[i]),
+// where bits has room for (n + 63) / 64 entries and the unused bits are cleared
+void consistent(const State & s, const Word * words, size_t n, uint64_t * bits);
+void consistent(const State & s, const uint8_t * const columns[word_length], size_t n, uint64_t * bits);
+
+// out[i] = letter_mask(words[i])
+void letter_masks(const Word * words, size_t n, uint32_t * out);
+void letter_masks(const uint8_t * const columns[word_length], size_t n, uint32_t * out);
+
+// the name of the variant in use
+const char * kernel_name();
@@ -0,0 +1,103 @@
+#include "kernel_variants.hpp"
+
+#if defined(WORDLE_X86)
+
+#include <immintrin.h>
+
+#define TARGET __attribute__((target("avx2")))
+
+// Mirrors get_clues(): letter i is GREEN if it matches the answer in place,
+// otherwise YELLOW if the answer has more copies of it outside the GREEN
+// positions than the guess has non-GREEN copies before position i. Both
+// counts are kept per byte, subtracting the all-ones compare masks.
+TARGET static __m256i pattern_block(Word guess, const __m256i answer[word_length]) {
+  __m256i green[word_length];
+  for (int j = 0; j < word_length; j++) {
+    green[j] = _mm256_cmpeq_epi8(answer[j], _mm256_set1_epi8(guess[j]));
+  }
+
+  const __m256i ones = _mm256_set1_epi8(char(0xFF));
+  __m256i code = _mm256_setzero_si256();
+  for (int i = 0; i < word_length; i++) {
+    __m256i letter = _mm256_set1_epi8(guess[i]);
+    __m256i available = _mm256_setzero_si256();
+    for (int j = 0; j < word_length; j++) {
+      __m256i match = _mm256_cmpeq_epi8(answer[j], letter);
+      available = _mm256_sub_epi8(available, _mm256_andnot_si256(green[j], match));
+    }
+    __m256i earlier = _mm256_setzero_si256();
+    for (int k = 0; k < i; k++) {
+      if (guess[k] == guess[i]) earlier = _mm256_sub_epi8(earlier, _mm256_andnot_si256(green[k], ones));
+    }
+    __m256i yellow = _mm256_andnot_si256(green[i], _mm256_cmpgt_epi8(available, earlier));
+    code = _mm256_add_epi8(code, _mm256_and_si256(green[i], _mm256_set1_epi8(char(2 * pattern_weight[i]))));
+    code = _mm256_add_epi8(code, _mm256_and_si256(yellow, _mm256_set1_epi8(char(pattern_weight[i]))));
+  }
+  return code;
+}
+
+TARGET static void pattern_codes(Word guess, const uint8_t * const columns[word_length], size_t n, uint8_t * out) {
+  __m256i answer[word_length];
+  for (size_t i = 0; i < n; i += 32) {
+    for (int j = 0; j < word_length; j++) {
+      answer[j] = _mm256_loadu_si256((const __m256i *)(columns[j] + i));
+    }
+    _mm256_storeu_si256((__m256i *)(out + i), pattern_block(guess, answer));
+  }
+}
+
+TARGET static void consistent(const State & s, const uint8_t * const columns[word_length], size_t n, uint64_t * bits) {
+  FilterTables t = filter_tables(s);
+
+  // byte shuffles only look within each 128-bit lane, so the tables go in both
+  __m256i lo[word_length], hi[word_length];
+  for (int j = 0; j < word_length; j++) {
+    lo[j] = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)t.forbidden_lo[j]));
+    hi[j] = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)t.forbidden_hi[j]));
+  }
+
+  for (size_t i = 0; i < n; i += 64) {
+    uint64_t block = 0;
+    for (size_t k = 0; k < 64; k += 32) {
+      __m256i c[word_length];
+      __m256i ok = _mm256_set1_epi8(char(0xFF));
+      for (int j = 0; j < word_length; j++) {
+        c[j] = _mm256_loadu_si256((const __m256i *)(columns[j] + i + k));
+        __m256i index = _mm256_sub_epi8(c[j], _mm256_set1_epi8('a'));
+        __m256i upper = _mm256_cmpgt_epi8(index, _mm256_set1_epi8(15));
+        __m256i forbidden = _mm256_blendv_epi8(_mm256_shuffle_epi8(lo[j], index), _mm256_shuffle_epi8(hi[j], index), upper);
+        ok = _mm256_andnot_si256(forbidden, ok);
+        if (t.matched[j] != '?') {
+          ok = _mm256_and_si256(ok, _mm256_cmpeq_epi8(c[j], _mm256_set1_epi8(t.matched[j])));
+        }
+      }
+      for (int u = 0; u < t.num_used; u++) {
+        __m256i letter = _mm256_set1_epi8(t.used[u]);
+        __m256i any = _mm256_setzero_si256();
+        for (int j = 0; j < word_length; j++) any = _mm256_or_si256(any, _mm256_cmpeq_epi8(c[j], letter));
+        ok = _mm256_and_si256(ok, any);
+      }
+      block |= uint64_t(uint32_t(_mm256_movemask_epi8(ok))) << k;
+    }
+    bits[i / 64] = block;
+  }
+}
+
+TARGET static void letter_masks(const uint8_t * const columns[word_length], size_t n, uint32_t * out) {
+  const __m256i one = _mm256_set1_epi32(1);
+  for (size_t i = 0; i < n; i += 8) {
+    __m256i mask = _mm256_setzero_si256();
+    for (int j = 0; j < word_length; j++) {
+      __m128i eight_letters = _mm_loadl_epi64((const __m128i *)(columns[j] + i));
+      __m256i index = _mm256_sub_epi32(_mm256_cvtepu8_epi32(eight_letters), _mm256_set1_epi32('a'));
+      mask = _mm256_or_si256(mask, _mm256_sllv_epi32(one, index));
+    }
+    _mm256_storeu_si256((__m256i *)(out + i), mask);
+  }
+}
+
+static bool supported() { return __builtin_cpu_supports("avx2"); }
+
+const Kernels avx2_kernels = {"avx2", supported, pattern_codes, consistent, letter_masks};
+
+#endif
@@ -0,0 +1,98 @@
+#include "kernel_variants.hpp"
+
+#if defined(WORDLE_X86)
+
+#include <immintrin.h>
+
+#define TARGET __attribute__((target("avx512f,avx512bw")))
+
+// the same as the AVX2 version, with the compares going into mask registers
+TARGET static __m512i pattern_block(Word guess, const __m512i answer[word_length]) {
+  __mmask64 green[word_length];
+  for (int j = 0; j < word_length; j++) {
+    green[j] = _mm512_cmpeq_epi8_mask(answer[j], _mm512_set1_epi8(guess[j]));
+  }
+
+  const __m512i one = _mm512_set1_epi8(1);
+  __m512i code = _mm512_setzero_si512();
+  for (int i = 0; i < word_length; i++) {
+    __m512i letter = _mm512_set1_epi8(guess[i]);
+    __m512i available = _mm512_setzero_si512();
+    for (int j = 0; j < word_length; j++) {
+      __mmask64 match = _mm512_cmpeq_epi8_mask(answer[j], letter) & ~green[j];
+      available = _mm512_mask_add_epi8(available, match, available, one);
+    }
+    __m512i earlier = _mm512_setzero_si512();
+    for (int k = 0; k < i; k++) {
+      if (guess[k] == guess[i]) earlier = _mm512_mask_add_epi8(earlier, ~green[k], earlier, one);
+    }
+    __mmask64 yellow = _mm512_cmpgt_epi8_mask(available, earlier) & ~green[i];
+    code = _mm512_mask_add_epi8(code, green[i], code, _mm512_set1_epi8(char(2 * pattern_weight[i])));
+    code = _mm512_mask_add_epi8(code, yellow, code, _mm512_set1_epi8(char(pattern_weight[i])));
+  }
+  return code;
+}
+
+TARGET static void pattern_codes(Word guess, const uint8_t * const columns[word_length], size_t n, uint8_t * out) {
+  __m512i answer[word_length];
+  for (size_t i = 0; i < n; i += 64) {
+    for (int j = 0; j < word_length; j++) {
+      answer[j] = _mm512_loadu_si512((const void *)(columns[j] + i));
+    }
+    _mm512_storeu_si512((void *)(out + i), pattern_block(guess, answer));
+  }
+}
+
+TARGET static void consistent(const State & s, const uint8_t * const columns[word_length], size_t n, uint64_t * bits) {
+  FilterTables t = filter_tables(s);
+
+  // byte shuffles only look within each 128-bit lane, so the tables go in all four
+  __m512i lo[word_length], hi[word_length];
+  for (int j = 0; j < word_length; j++) {
+    lo[j] = _mm512_broadcast_i32x4(_mm_load_si128((const __m128i *)t.forbidden_lo[j]));
+    hi[j] = _mm512_broadcast_i32x4(_mm_load_si128((const __m128i *)t.forbidden_hi[j]));
+  }
+
+  for (size_t i = 0; i < n; i += 64) {
+    __m512i c[word_length];
+    __mmask64 ok = ~__mmask64(0);
+    for (int j = 0; j < word_length; j++) {
+      c[j] = _mm512_loadu_si512((const void *)(columns[j] + i));
+      __m512i index = _mm512_sub_epi8(c[j], _mm512_set1_epi8('a'));
+      __mmask64 upper = _mm512_cmpgt_epi8_mask(index, _mm512_set1_epi8(15));
+      __m512i forbidden = _mm512_mask_blend_epi8(upper, _mm512_shuffle_epi8(lo[j], index), _mm512_shuffle_epi8(hi[j], index));
+      ok &= ~_mm512_test_epi8_mask(forbidden, forbidden);
+      if (t.matched[j] != '?') {
+        ok &= _mm512_cmpeq_epi8_mask(c[j], _mm512_set1_epi8(t.matched[j]));
+      }
+    }
+    for (int u = 0; u < t.num_used; u++) {
+      __m512i letter = _mm512_set1_epi8(t.used[u]);
+      __mmask64 any = 0;
+      for (int j = 0; j < word_length; j++) any |= _mm512_cmpeq_epi8_mask(c[j], letter);
+      ok &= any;
+    }
+    bits[i / 64] = ok;
+  }
+}
+
+TARGET static void letter_masks(const uint8_t * const columns[word_length], size_t n, uint32_t * out) {
+  const __m512i one = _mm512_set1_epi32(1);
+  for (size_t i = 0; i < n; i += 16) {
+    __m512i mask = _mm512_setzero_si512();
+    for (int j = 0; j < word_length; j++) {
+      __m128i sixteen_letters = _mm_loadu_si128((const __m128i *)(columns[j] + i));
+      __m512i index = _mm512_sub_epi32(_mm512_cvtepu8_epi32(sixteen_letters), _mm512_set1_epi32('a'));
+      mask = _mm512_or_si512(mask, _mm512_sllv_epi32(one, index));
+    }
+    _mm512_storeu_si512((void *)(out + i), mask);
+  }
+}
+
+static bool supported() {
+  return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+}
+
+const Kernels avx512_kernels = {"avx512", supported, pattern_codes, consistent, letter_masks};
+
+#endif
@@ -0,0 +1,43 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+
+// values below 32 get a bucket each, and after that the bucket
+// is the leading bit's position plus the next five bits
+size_t LatencyHistogram::bucket(uint64_t ns) {
+  if (ns < sub_buckets) return size_t(ns);
+  int shift = (63 - __builtin_clzll(ns)) - sub_bucket_bits;
+  return size_t((uint64_t(shift + 1) << sub_bucket_bits) + ((ns >> shift) - sub_buckets));
+}
+
+uint64_t LatencyHistogram::highest_in(size_t b) {
+  if (b < sub_buckets) return b;
+  int shift = int(b >> sub_bucket_bits) - 1;
+  uint64_t lowest = (sub_buckets + (b & (sub_buckets - 1))) << shift;
+  return lowest + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+  counts[bucket(ns)]++;
+  total++;
+  sum += ns;
+  largest = std::max(largest, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram & other) {
+  for (size_t b = 0; b < num_buckets; b++) counts[b] += other.counts[b];
+  total += other.total;
+  sum += other.sum;
+  largest = std::max(largest, other.largest);
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+  if (total == 0) return 0;
+  uint64_t wanted = std::max< uint64_t >(1, uint64_t(p / 100.0 * total + 0.5));
+  uint64_t seen = 0;
+  for (size_t b = 0; b < num_buckets; b++) {
+    seen += counts[b];
+    if (seen >= wanted) return std::min(highest_in(b), largest);
+  }
+  return largest;
+}
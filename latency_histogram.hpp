@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Latencies in nanoseconds, counted in log-linear buckets the way
+// HdrHistogram does it: every power of two is split into 32 equal buckets,
+// so any value is known to within about 3% at a fixed 15 KiB, however long
+// the tail. Recording is an index computation and an increment, and
+// histograms kept by separate threads can be merged at the end.
+class LatencyHistogram {
+ public:
+  void record(uint64_t ns);
+  void merge(const LatencyHistogram & other);
+
+  uint64_t count() const { return total; }
+  uint64_t max() const { return largest; }
+  double mean() const { return total ? double(sum) / total : 0.0; }
+
+  // the smallest value that at least p percent of the samples are less than
+  // or equal to, give or take the width of its bucket
+  uint64_t percentile(double p) const;
+
+ private:
+  static constexpr int sub_bucket_bits = 5;
+  static constexpr uint64_t sub_buckets = uint64_t(1) << sub_bucket_bits;
+  static constexpr size_t num_buckets = sub_buckets * (64 - sub_bucket_bits + 1);
+
+  static size_t bucket(uint64_t ns);
+  static uint64_t highest_in(size_t bucket);
+
+  std::array< uint64_t, num_buckets > counts{};
+  uint64_t total = 0;
+  uint64_t sum = 0;
+  uint64_t largest = 0;
+};
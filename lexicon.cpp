@@ -0,0 +1,75 @@
+#include "lexicon.hpp"
+
+#include "kernels.hpp"
+
+Lexicon::Lexicon(WordList words) : n(words.size()) {
+  for (int j = 0; j < word_length; j++) {
+    letters[j].resize(n);
+    for (size_t i = 0; i < n; i++) letters[j][i] = uint8_t(words[i][j]);
+    column_ptrs[j] = letters[j].data();
+  }
+
+  mask_storage.resize(n);
+  letter_masks(column_ptrs, n, mask_storage.data());
+  mask_ptr = mask_storage.data();
+}
+
+Lexicon::Lexicon(const BuiltinLexicon & builtin) : n(builtin.words.size()), mask_ptr(builtin.masks) {
+  for (int j = 0; j < word_length; j++) column_ptrs[j] = builtin.columns[j];
+}
+
+// the compiled-in lists come with their columns already laid out
+static Lexicon lexicon_for(WordList words, const BuiltinLexicon & builtin) {
+  if (words.data() == builtin.words.data() && words.size() == builtin.words.size()) return Lexicon(builtin);
+  return Lexicon(words);
+}
+
+CandidateSet select(const Lexicon & words, const State & s) {
+  CandidateSet filtered(words.size());
+  consistent(s, words.columns(), words.size(), filtered.blocks.data());
+  return filtered;
+}
+
+size_t num_remaining_words(const Lexicon & words, const State & s) {
+  return select(words, s).size();
+}
+
+// only the blocks of 64 words that still have candidates in them get filtered
+template < typename callable >
+static void for_each_consistent_block(const Lexicon & words, const CandidateSet & candidates, const State & s, callable f) {
+  const uint8_t * block[word_length];
+  for (uint32_t b = 0; b < candidates.active_blocks(); b++) {
+    if (candidates.blocks[b] == 0) continue;
+    size_t begin = size_t(b) * 64;
+    for (int j = 0; j < word_length; j++) block[j] = words.columns()[j] + begin;
+    uint64_t bits;
+    consistent(s, block, std::min(words.size() - begin, size_t(64)), &bits);
+    f(b, bits & candidates.blocks[b]);
+  }
+}
+
+CandidateSet select(const Lexicon & words, const CandidateSet & candidates, const State & s) {
+  CandidateSet filtered(candidates.n);
+  for_each_consistent_block(words, candidates, s, [&](uint32_t b, uint64_t bits) {
+    filtered.blocks[b] = bits;
+  });
+  return filtered;
+}
+
+size_t num_remaining_words(const Lexicon & words, const CandidateSet & candidates, const State & s) {
+  size_t remaining = 0;
+  for_each_consistent_block(words, candidates, s, [&](uint32_t, uint64_t bits) {
+    remaining += __builtin_popcountll(bits);
+  });
+  return remaining;
+}
+
+const Lexicon & words_lexicon() {
+  static const Lexicon lexicon = lexicon_for(all_words, builtin_words);
+  return lexicon;
+}
+
+const Lexicon & answers_lexicon() {
+  static const Lexicon lexicon = lexicon_for(all_answers, builtin_answers);
+  return lexicon;
+}
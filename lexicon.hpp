@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "wordle_tools.hpp"
+#include "builtin_lexicon.hpp"
+
+// A list of words stored column-wise: one byte array per letter position and
+// one array of letter masks, so that checking many words against a State can
+// be done a vector register's worth of words at a time.
+struct Lexicon {
+  Lexicon() : n(0), column_ptrs{}, mask_ptr(nullptr) {}
+  explicit Lexicon(WordList words);
+
+  // a view of columns that were laid out ahead of time, with no copying
+  explicit Lexicon(const BuiltinLexicon & builtin);
+
+  // columns() may point into our own storage, so copies would dangle
+  Lexicon(const Lexicon &) = delete;
+  Lexicon & operator=(const Lexicon &) = delete;
+  Lexicon(Lexicon &&) = default;
+  Lexicon & operator=(Lexicon &&) = default;
+
+  size_t size() const { return n; }
+
+  Word operator[](size_t i) const {
+    Word w;
+    for (int j = 0; j < word_length; j++) w[j] = char(column_ptrs[j][i]);
+    return w;
+  }
+
+  // pointers to the start of each letter position's column
+  const uint8_t * const * columns() const { return column_ptrs; }
+
+  // the letter_mask() of each word
+  const uint32_t * masks() const { return mask_ptr; }
+
+  size_t n;
+
+ private:
+  // empty when viewing a BuiltinLexicon
+  std::vector< uint8_t > letters[word_length];
+  std::vector< uint32_t > mask_storage;
+
+  const uint8_t * column_ptrs[word_length];
+  const uint32_t * mask_ptr;
+};
+
+// the words in the lexicon consistent with s, as indices into it
+CandidateSet select(const Lexicon & words, const State & s);
+size_t num_remaining_words(const Lexicon & words, const State & s);
+
+// the same, restricted to a set of candidates
+CandidateSet select(const Lexicon & words, const CandidateSet & candidates, const State & s);
+size_t num_remaining_words(const Lexicon & words, const CandidateSet & candidates, const State & s);
+
+// all_words and all_answers, column-wise (and for the compiled-in
+// lists, straight from the tables the compiler laid out)
+const Lexicon & words_lexicon();
+const Lexicon & answers_lexicon();
@@ -0,0 +1,109 @@
+#include "lexicon_file.hpp"
+
+#include "profiler.hpp"
+#include "wordle_tools.hpp"
+#include "builtin_lexicon.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+uint64_t lexicon_file::checksum(const void * data, size_t size) {
+  const uint8_t * bytes = (const uint8_t *)data;
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+bool write_lexicon(WordList words, WordList answers, const std::string & filename) {
+
+  // the rows are checksummed as they will appear in the file
+  std::vector< Word > rows(words.begin(), words.end());
+  rows.insert(rows.end(), answers.begin(), answers.end());
+
+  lexicon_file::Header header{};
+  std::memcpy(header.magic, lexicon_file::magic, sizeof(header.magic));
+  header.version = lexicon_file::version;
+  header.num_words = uint32_t(words.size());
+  header.num_answers = uint32_t(answers.size());
+  header.checksum = lexicon_file::checksum(rows.data(), rows.size() * sizeof(Word));
+
+  std::ofstream outfile(filename, std::ios::binary);
+  outfile.write((const char *)&header, sizeof(header));
+  outfile.write((const char *)rows.data(), std::streamsize(rows.size() * sizeof(Word)));
+  return bool(outfile);
+
+}
+
+// maps the file for the lifetime of the program, or exits saying why it can't
+static Lexicons map_lexicon(const std::string & filename) {
+  PROFILE_ZONE("load lexicon");
+
+  auto fail = [&](const char * reason) {
+    std::cerr << "WORDLE_LEXICON: " << filename << ": " << reason << std::endl;
+    exit(1);
+  };
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) fail("could not open file");
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) fail("could not stat file");
+  size_t length = size_t(info.st_size);
+  if (length < sizeof(lexicon_file::Header)) fail("not a lexicon file");
+
+  void * data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) fail("could not map file");
+
+  const lexicon_file::Header * header = (const lexicon_file::Header *)data;
+  const Word * rows = (const Word *)(header + 1);
+
+  if (std::memcmp(header->magic, lexicon_file::magic, sizeof(header->magic)) != 0) fail("not a lexicon file");
+  if (header->version != lexicon_file::version) fail("unsupported lexicon version");
+
+  size_t num_rows = size_t(header->num_words) + header->num_answers;
+  if (length != sizeof(lexicon_file::Header) + num_rows * sizeof(Word)) fail("truncated lexicon file");
+  if (lexicon_file::checksum(rows, num_rows * sizeof(Word)) != header->checksum) fail("checksum mismatch");
+  if (header->num_words > CandidateSet::capacity || header->num_answers > CandidateSet::capacity) {
+    fail("too many words");
+  }
+
+  for (size_t i = 0; i < num_rows; i++) {
+    for (int j = 0; j < word_length; j++) {
+      if (rows[i][j] < 'a' || rows[i][j] > 'z') fail("words must be 5 lowercase letters");
+    }
+  }
+
+  return Lexicons{WordList(rows, header->num_words), WordList(rows + header->num_words, header->num_answers), filename};
+}
+
+const Lexicons & lexicons() {
+  static const Lexicons lists = [](){
+#if !defined(WORDLE_EMBEDDED_LEXICON)
+    if (const char * filename = std::getenv("WORDLE_LEXICON")) return map_lexicon(filename);
+#endif
+    return Lexicons{builtin_words.words, builtin_answers.words, "compiled-in"};
+  }();
+  return lists;
+}
+
+uint64_t lexicon_checksum() {
+  uint64_t words = lexicon_file::checksum(all_words.data(), all_words.size() * sizeof(Word));
+  uint64_t answers = lexicon_file::checksum(all_answers.data(), all_answers.size() * sizeof(Word));
+  return words ^ (answers * 0x9E3779B97F4A7C15ull);
+}
+
+#if !defined(WORDLE_EMBEDDED_LEXICON)
+const WordList all_words = lexicons().words;
+const WordList all_answers = lexicons().answers;
+#endif
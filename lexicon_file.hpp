@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "word_list.hpp"
+
+// A lexicon file holds both word lists as packed 5-byte rows after a 32-byte
+// header, all words first and then the answers. The rows are used in place,
+// straight out of mmap(), and the header's checksum (64-bit FNV-1a over the
+// rows) is checked before anything else reads them.
+namespace lexicon_file {
+
+  constexpr char magic[8] = {'W', 'R', 'D', 'L', 'W', 'O', 'R', 'D'};
+  constexpr uint32_t version = 1;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_words;
+    uint32_t num_answers;
+    uint32_t reserved;
+    uint64_t checksum;
+  };
+
+  static_assert(sizeof(Header) == 32);
+
+  uint64_t checksum(const void * data, size_t size);
+
+}
+
+// returns false if the file couldn't be written
+bool write_lexicon(WordList words, WordList answers, const std::string & filename);
+
+// The word lists every program uses, as all_words and all_answers. They come
+// from the lexicon file named by the WORDLE_LEXICON environment variable if
+// it is set (exiting with a message if that file is missing or invalid), and
+// otherwise from the lists compiled into the binary. Builds configured with
+// WORDLE_EMBEDDED_LEXICON only ever use the compiled-in lists.
+struct Lexicons {
+  WordList words;
+  WordList answers;
+  std::string source; // the file, or "compiled-in"
+};
+
+const Lexicons & lexicons();
+
+// a checksum of the word lists in use, which files computed from them
+// (like a saved guess cache or an opening book) record to detect when
+// they are loaded with different lists
+uint64_t lexicon_checksum();
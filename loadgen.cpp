@@ -0,0 +1,316 @@
+#include "wordle_tools.hpp"
+#include "word_index.hpp"
+#include "opening_book.hpp"
+#include "pattern_index.hpp"
+#include "latency_histogram.hpp"
+
+#include <array>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+void usage() {
+  std::cout << "usage: loadgen [--game ADDRESS] [--solver ADDRESS] [--connections N]" << std::endl;
+  std::cout << "               [--games N | --seconds S]" << std::endl;
+  std::cout << "  plays full games over N connections to a `wordle --serve` game server and/or" << std::endl;
+  std::cout << "  a `solver --serve` daemon (the bot), where an ADDRESS is a port on 127.0.0.1" << std::endl;
+  std::cout << "  or the path of a Unix socket. Without a game server the games are scored" << std::endl;
+  std::cout << "  locally, and without a daemon the bot runs in-process (but one is needed)." << std::endl;
+  exit(1);
+}
+
+struct Options {
+  std::string game;
+  std::string solver;
+  int connections = 16;
+  uint64_t games = 1000;
+  double seconds = 0.0; // if set, play for this long instead of a number of games
+};
+
+// the kinds of request timed separately
+enum Request { GUESS, NEW_GAME, SOLVE, num_requests };
+const char * request_names[num_requests] = {"guess", "new", "solve"};
+
+std::string text(Word w) { return std::string(w.data, word_length); }
+
+// a blocking line-at-a-time connection to one of the servers
+class Connection {
+ public:
+  explicit Connection(const std::string & address);
+  ~Connection() { close(fd); }
+
+  // sends a line and waits for the one-line response
+  std::string request(const std::string & line);
+
+ private:
+  int fd;
+  std::string pending;
+};
+
+Connection::Connection(const std::string & address) {
+  bool is_port = !address.empty() && address.find_first_not_of("0123456789") == std::string::npos;
+  if (is_port) {
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    a.sin_port = htons(uint16_t(std::stoi(address)));
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr *)&a, sizeof(a)) == 0) return;
+  } else {
+    sockaddr_un a{};
+    a.sun_family = AF_UNIX;
+    std::strncpy(a.sun_path, address.c_str(), sizeof(a.sun_path) - 1);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr *)&a, sizeof(a)) == 0) return;
+  }
+  std::cout << "could not connect to " << address << ": " << std::strerror(errno) << std::endl;
+  exit(1);
+}
+
+std::string Connection::request(const std::string & line) {
+  std::string out = line + '\n';
+  for (size_t sent = 0; sent < out.size(); ) {
+    ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0) return "err connection lost";
+    sent += size_t(n);
+  }
+
+  size_t newline;
+  while ((newline = pending.find('\n')) == std::string::npos) {
+    char buffer[4096];
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n <= 0) return "err connection lost";
+    pending.append(buffer, size_t(n));
+  }
+  std::string response = pending.substr(0, newline);
+  pending.erase(0, newline + 1);
+  return response;
+}
+
+// The in-process bot plays like wordle_solve(), with the same opening book
+// and cache of guesses.
+class LocalBot {
+ public:
+  // the next guess after the given turns, given as (guess, pattern) pairs
+  int next_guess(const std::vector< std::pair< int, uint8_t > > & turns);
+};
+
+int LocalBot::next_guess(const std::vector< std::pair< int, uint8_t > > & turns) {
+  if (turns.empty()) return opening_guess();
+
+  CandidateSet candidates = CandidateSet::all(all_answers.size());
+  for (auto [guess, pattern] : turns) candidates = pattern_index().select(guess, candidates, pattern);
+  if (candidates.size() == 0) return -1;
+  if (candidates.size() == 1) return words_index().find(all_answers[candidates.first()]);
+
+  return best_guess(candidates, turns);
+}
+
+// feedback in the servers' g/y/b form, or -1 if it isn't that
+int parse_feedback(const std::string & s) {
+  if (s.size() < word_length) return -1;
+  std::array< Clue, 5 > clues{};
+  for (int i = 0; i < word_length; i++) {
+    if (s[i] == 'g') clues[i] = GREEN;
+    else if (s[i] == 'y') clues[i] = YELLOW;
+    else if (s[i] == 'b') clues[i] = GRAY;
+    else return -1;
+  }
+  return encode(clues);
+}
+
+// what each connection keeps for itself, merged at the end
+struct alignas(64) Tally {
+  LatencyHistogram latency[num_requests];
+  uint64_t games = 0;
+  uint64_t won = 0;
+  uint64_t guesses = 0;
+  uint64_t errors = 0;
+};
+
+class LoadGenerator {
+ public:
+  explicit LoadGenerator(const Options & options) : options(options), games_started(0) {}
+
+  void run();
+
+ private:
+  void play(Tally & tally, uint32_t seed);
+  bool play_game(Tally & tally, Connection * game, Connection * solver, std::mt19937 & random);
+  bool keep_going();
+
+  Options options;
+  LocalBot bot;
+  std::atomic< uint64_t > games_started;
+  std::chrono::steady_clock::time_point deadline;
+};
+
+bool LoadGenerator::keep_going() {
+  if (options.seconds > 0) return std::chrono::steady_clock::now() < deadline;
+  return games_started++ < options.games;
+}
+
+template < typename callable >
+auto timed(LatencyHistogram & histogram, callable f) {
+  auto start = std::chrono::steady_clock::now();
+  auto result = f();
+  histogram.record(uint64_t(std::chrono::duration_cast< std::chrono::nanoseconds >(std::chrono::steady_clock::now() - start).count()));
+  return result;
+}
+
+// plays one game, returning false if anything went wrong
+bool LoadGenerator::play_game(Tally & tally, Connection * game, Connection * solver, std::mt19937 & random) {
+  int answer = std::uniform_int_distribution< int >(0, int(all_answers.size()) - 1)(random);
+  std::vector< std::pair< int, uint8_t > > turns;
+  std::string history;
+
+  for (int turn = 1; turn <= 6; turn++) {
+
+    int guess;
+    if (solver) {
+      std::string response = timed(tally.latency[SOLVE], [&](){ return solver->request(history); });
+      if (response.compare(0, 3, "ok ") != 0 || response.size() < 3 + word_length) return false;
+      guess = words_index().find(Word(response.substr(3, word_length)));
+    } else {
+      guess = bot.next_guess(turns);
+    }
+    if (guess < 0) return false;
+
+    int pattern;
+    bool over = false;
+    if (game) {
+      std::string response = timed(tally.latency[GUESS], [&](){ return game->request(text(all_words[guess])); });
+      pattern = (response.compare(0, 3, "ok ") == 0) ? parse_feedback(response.substr(3)) : -1;
+      over = response.find(" won") != std::string::npos || response.find(" lost") != std::string::npos;
+    } else {
+      pattern = get_pattern(all_answers[answer], all_words[guess]);
+    }
+    if (pattern < 0) return false;
+
+    tally.guesses++;
+    if (pattern == all_green) {
+      tally.won++;
+      return true;
+    }
+    if (over) return true;
+
+    turns.push_back({guess, uint8_t(pattern)});
+    history += text(all_words[guess]) + " ";
+    for (auto clue : all_clues[pattern]) history += "byg"[clue];
+    history += " ";
+  }
+  return true;
+}
+
+void LoadGenerator::play(Tally & tally, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::unique_ptr< Connection > game, solver;
+  if (!options.game.empty()) game = std::make_unique< Connection >(options.game);
+  if (!options.solver.empty()) solver = std::make_unique< Connection >(options.solver);
+
+  // the game server starts a game for each new connection
+  for (bool first = true; keep_going(); first = false) {
+    if (game && !first) {
+      std::string response = timed(tally.latency[NEW_GAME], [&](){ return game->request("new"); });
+      if (response != "ok") {
+        tally.errors++;
+        return;
+      }
+    }
+    tally.games++;
+    if (!play_game(tally, game.get(), solver.get(), random)) {
+      tally.errors++;
+      return;
+    }
+  }
+}
+
+void LoadGenerator::run() {
+
+  // the lexicon and pattern tables load before the clock starts
+  words_index();
+  if (options.solver.empty()) bot.next_guess({});
+
+  std::vector< Tally > tallies(options.connections);
+  std::vector< std::thread > threads;
+  auto start = std::chrono::steady_clock::now();
+  deadline = start + std::chrono::duration_cast< std::chrono::steady_clock::duration >(std::chrono::duration< double >(options.seconds));
+  for (int i = 0; i < options.connections; i++) {
+    threads.emplace_back([this, &tallies, i](){ play(tallies[i], uint32_t(i + 1)); });
+  }
+  for (auto & t : threads) t.join();
+  double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - start).count();
+
+  Tally total;
+  for (auto & t : tallies) {
+    for (int r = 0; r < num_requests; r++) total.latency[r].merge(t.latency[r]);
+    total.games += t.games;
+    total.won += t.won;
+    total.guesses += t.guesses;
+    total.errors += t.errors;
+  }
+
+  std::cout << total.games << " games over " << options.connections << " connections in " << seconds << "s (";
+  std::cout << total.games / seconds << " games/s)" << std::endl;
+  std::cout << "won " << total.won << ", " << double(total.guesses) / std::max< uint64_t >(total.games, 1) << " guesses per game";
+  std::cout << ", " << total.errors << " errors" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(8) << "request" << std::right;
+  for (auto heading : {"count", "req/s", "mean", "p50", "p90", "p99", "p99.9", "max"}) std::cout << std::setw(11) << heading;
+  std::cout << "   (latencies in us)" << std::endl;
+
+  auto us = [](double ns) { return ns / 1e3; };
+  std::cout << std::fixed << std::setprecision(1);
+  for (int r = 0; r < num_requests; r++) {
+    const LatencyHistogram & h = total.latency[r];
+    if (h.count() == 0) continue;
+    std::cout << std::left << std::setw(8) << request_names[r] << std::right;
+    std::cout << std::setw(11) << h.count() << std::setw(11) << h.count() / seconds;
+    std::cout << std::setw(11) << us(h.mean());
+    for (double p : {50.0, 90.0, 99.0, 99.9}) std::cout << std::setw(11) << us(double(h.percentile(p)));
+    std::cout << std::setw(11) << us(double(h.max())) << std::endl;
+  }
+}
+
+int main(int argc, char * argv[]) {
+
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 == argc) usage();
+    if (arg == "--game") {
+      options.game = argv[++i];
+    } else if (arg == "--solver") {
+      options.solver = argv[++i];
+    } else if (arg == "--connections") {
+      options.connections = std::atoi(argv[++i]);
+      if (options.connections <= 0) usage();
+    } else if (arg == "--games") {
+      options.games = std::strtoull(argv[++i], nullptr, 10);
+      if (options.games == 0) usage();
+    } else if (arg == "--seconds") {
+      options.seconds = std::atof(argv[++i]);
+      if (options.seconds <= 0) usage();
+    } else {
+      usage();
+    }
+  }
+  if (options.game.empty() && options.solver.empty()) usage();
+
+  LoadGenerator(options).run();
+
+}
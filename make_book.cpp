@@ -0,0 +1,66 @@
+#include "wordle_tools.hpp"
+#include "opening_book.hpp"
+#include "thread_pool.hpp"
+#include "timer.hpp"
+
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+void usage() {
+  std::cout << "usage: make_book OUTPUT [--depth 2|3] [--opener WORD] [--objective worst|expected|entropy] [--threads N]" << std::endl;
+  std::cout << "  writes the best replies to the opener (by default the solvers' own) for" << std::endl;
+  std::cout << "  the first 2 or 3 guesses, for use with WORDLE_OPENING_BOOK=OUTPUT; the" << std::endl;
+  std::cout << "  solvers use books made with the default objective, worst" << std::endl;
+  exit(1);
+}
+
+int main(int argc, char * argv[]) {
+
+  if (argc < 2) usage();
+  std::string output = argv[1];
+  int depth = 2;
+  int opener = -1;
+  Objective objective = WORST_CASE;
+  std::string objective_name = "worst";
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 == argc) usage();
+    if (arg == "--depth") {
+      depth = std::atoi(argv[++i]);
+      if (depth != 2 && depth != 3) usage();
+    } else if (arg == "--opener") {
+      std::string word = argv[++i];
+      opener = (word.size() == word_length) ? index_of(all_words, Word(word)) : -1;
+      if (opener < 0) {
+        std::cout << word << " is not a valid guess" << std::endl;
+        exit(1);
+      }
+    } else if (arg == "--objective") {
+      objective_name = argv[++i];
+      if (objective_name == "worst") objective = WORST_CASE;
+      else if (objective_name == "expected") objective = EXPECTED_SIZE;
+      else if (objective_name == "entropy") objective = ENTROPY;
+      else usage();
+    } else if (arg == "--threads") {
+      int n = std::atoi(argv[++i]);
+      if (n <= 0) usage();
+      set_num_threads(n);
+    } else {
+      usage();
+    }
+  }
+  if (opener < 0) opener = opening_guess();
+
+  OpeningBook book;
+  double seconds = runtime([&](){ book = OpeningBook::generate(opener, depth, objective); });
+
+  if (!book.save(output)) {
+    std::cout << "could not write " << output << std::endl;
+    exit(1);
+  }
+  std::cout << "wrote a book of depth " << depth << " for " << all_words[opener];
+  std::cout << " with the " << objective_name << " objective to " << output;
+  std::cout << " in " << seconds << "s on " << thread_pool().size() << " threads" << std::endl;
+
+}
@@ -0,0 +1,69 @@
+#include "wordle_tools.hpp"
+#include "lexicon_file.hpp"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+void usage() {
+  std::cout << "usage: make_lexicon OUTPUT [WORDS.txt ANSWERS.txt]" << std::endl;
+  std::cout << "  writes the given lists (one word per line), or else the ones in use" << std::endl;
+  exit(1);
+}
+
+// every line must be exactly one 5-letter lowercase word, so that mistakes
+// are reported instead of silently turning into a different word
+std::vector< Word > read_words(const std::string & filename) {
+  std::ifstream infile(filename);
+  if (!infile) {
+    std::cout << "could not open " << filename << std::endl;
+    exit(1);
+  }
+
+  std::vector< Word > words;
+  std::string line;
+  for (int line_number = 1; std::getline(infile, line); line_number++) {
+    if (line.empty()) continue;
+    bool valid = (line.size() == word_length);
+    for (auto c : line) valid = valid && (c >= 'a' && c <= 'z');
+    if (!valid) {
+      std::cout << filename << ":" << line_number << ": \"" << line << "\" is not a 5-letter word" << std::endl;
+      exit(1);
+    }
+    words.push_back(Word(line));
+  }
+  return words;
+}
+
+int main(int argc, char * argv[]) {
+
+  if (argc != 2 && argc != 4) usage();
+
+  std::vector< Word > words(all_words.begin(), all_words.end());
+  std::vector< Word > answers(all_answers.begin(), all_answers.end());
+  if (argc == 4) {
+    words = read_words(argv[2]);
+    answers = read_words(argv[3]);
+  }
+
+  if (words.size() > CandidateSet::capacity || answers.size() > CandidateSet::capacity) {
+    std::cout << "at most " << CandidateSet::capacity << " words per list are supported" << std::endl;
+    exit(1);
+  }
+
+  int unguessable = 0;
+  for (auto answer : answers) {
+    if (index_of(words, answer) < 0) unguessable++;
+  }
+  if (unguessable > 0) {
+    std::cout << "warning: " << unguessable << " answers are not in the list of words" << std::endl;
+  }
+
+  if (!write_lexicon(words, answers, argv[1])) {
+    std::cout << "could not write " << argv[1] << std::endl;
+    exit(1);
+  }
+  std::cout << "wrote " << words.size() << " words and " << answers.size() << " answers to " << argv[1] << std::endl;
+
+}
@@ -0,0 +1,155 @@
+#include "opening_book.hpp"
+
+#include "guess_cache.hpp"
+#include "lexicon_file.hpp"
+#include "pattern_index.hpp"
+#include "profiler.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+  // a saved book is this header and then the replies, as in memory
+  constexpr char magic[8] = {'W', 'R', 'D', 'L', 'B', 'O', 'O', 'K'};
+  constexpr uint32_t version = 2;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint16_t opener;
+    uint16_t depth;
+    uint32_t num_replies;
+    uint32_t objective; // what the replies were chosen to minimize
+    uint64_t lexicon;   // lexicon_checksum() of the lists it was made with
+  };
+
+  static_assert(sizeof(Header) == 32);
+
+  size_t num_replies(int depth) {
+    return (depth == 3) ? num_patterns + num_patterns * num_patterns : num_patterns;
+  }
+
+}
+
+size_t OpeningBook::slot(const uint8_t * patterns, int n) {
+  if (n == 1) return patterns[0];
+  return num_patterns + size_t(patterns[0]) * num_patterns + patterns[1];
+}
+
+OpeningBook OpeningBook::generate(int opener, int depth, Objective objective) {
+  PROFILE_ZONE("generate opening book");
+
+  OpeningBook book;
+  book.first = uint16_t(opener);
+  book.max_depth = depth;
+  book.goal = objective;
+  book.replies.assign(num_replies(depth), none);
+
+  const PatternIndex & index = pattern_index();
+  const CandidateSet all = CandidateSet::all(all_answers.size());
+
+  // every second guess, and then the third guesses that follow from them,
+  // one at a time, since each search already uses the whole thread pool
+  for (size_t p = 0; p < num_patterns; p++) {
+    CandidateSet candidates = index.select(opener, all, uint8_t(p));
+    if (candidates.size() >= 2) book.replies[p] = uint16_t(best_guess(candidates, objective));
+  }
+  if (depth < 3) return book;
+
+  for (size_t p = 0; p < num_patterns; p++) {
+    uint16_t second = book.replies[p];
+    if (second == none) continue;
+    CandidateSet after_opener = index.select(opener, all, uint8_t(p));
+    for (size_t q = 0; q < num_patterns; q++) {
+      uint8_t patterns[2] = {uint8_t(p), uint8_t(q)};
+      CandidateSet candidates = index.select(second, after_opener, patterns[1]);
+      if (candidates.size() >= 2) book.replies[slot(patterns, 2)] = uint16_t(best_guess(candidates, objective));
+    }
+  }
+  return book;
+}
+
+int OpeningBook::next_guess(const std::vector< std::pair< int, uint8_t > > & turns) const {
+  if (empty() || turns.empty() || int(turns.size()) >= max_depth || turns[0].first != first) return -1;
+
+  uint8_t patterns[2];
+  for (size_t i = 0; i < turns.size(); i++) {
+    // any guess after the opener has to be the one the book made
+    if (i > 0 && turns[i].first != replies[slot(patterns, int(i))]) return -1;
+    patterns[i] = turns[i].second;
+  }
+
+  uint16_t guess = replies[slot(patterns, int(turns.size()))];
+  return (guess == none) ? -1 : int(guess);
+}
+
+bool OpeningBook::save(const std::string & filename) const {
+  Header header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.opener = first;
+  header.depth = uint16_t(max_depth);
+  header.num_replies = uint32_t(replies.size());
+  header.objective = uint32_t(goal);
+  header.lexicon = lexicon_checksum();
+
+  std::ofstream outfile(filename, std::ios::binary);
+  outfile.write((const char *)&header, sizeof(header));
+  outfile.write((const char *)replies.data(), std::streamsize(replies.size() * sizeof(uint16_t)));
+  return bool(outfile);
+}
+
+OpeningBook OpeningBook::load(const std::string & filename) {
+  PROFILE_ZONE("load opening book");
+
+  auto fail = [&](const char * reason) {
+    std::cerr << "opening book " << filename << ": " << reason << std::endl;
+    exit(1);
+  };
+
+  std::ifstream infile(filename, std::ios::binary);
+  if (!infile) fail("could not open file");
+
+  Header header{};
+  if (!infile.read((char *)&header, sizeof(header))) fail("not an opening book");
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) fail("not an opening book");
+  if (header.version != version) fail("unsupported opening book version");
+  if (header.lexicon != lexicon_checksum()) fail("made for different word lists");
+  if ((header.depth != 2 && header.depth != 3) || header.num_replies != num_replies(header.depth)) {
+    fail("damaged opening book");
+  }
+  if (header.objective > ENTROPY) fail("damaged opening book");
+
+  OpeningBook book;
+  book.first = header.opener;
+  book.max_depth = header.depth;
+  book.goal = Objective(header.objective);
+  book.replies.resize(header.num_replies);
+  if (!infile.read((char *)book.replies.data(), std::streamsize(book.replies.size() * sizeof(uint16_t)))) {
+    fail("truncated opening book");
+  }
+
+  if (book.first >= all_words.size()) fail("damaged opening book");
+  for (auto guess : book.replies) {
+    if (guess != none && guess >= all_words.size()) fail("damaged opening book");
+  }
+  return book;
+}
+
+int best_guess(const CandidateSet & candidates, const std::vector< std::pair< int, uint8_t > > & turns,
+               Objective objective) {
+  const OpeningBook & book = opening_book();
+  int guess = (book.objective() == objective) ? book.next_guess(turns) : -1;
+  return (guess >= 0) ? guess : best_guess(candidates, objective);
+}
+
+const OpeningBook & opening_book() {
+  static const OpeningBook book = [](){
+    if (const char * filename = std::getenv("WORDLE_OPENING_BOOK")) return OpeningBook::load(filename);
+    return OpeningBook();
+  }();
+  return book;
+}
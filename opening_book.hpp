@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "wordle_tools.hpp"
+
+// The replies best_guess() would make in the first turns after a fixed
+// opener, worked out ahead of time. A reply only depends on the feedback to
+// the guesses before it, so the book is a dense table indexed by those
+// patterns: 243 second guesses for a book of depth 2, and 243 * 243 third
+// guesses on top of that for depth 3. Looking one up is a single index.
+//
+// Positions with fewer than two answers left have no entry, since the
+// solvers handle those without searching anyway.
+class OpeningBook {
+ public:
+  static constexpr uint16_t none = 0xFFFF;
+
+  // an empty book, which covers nothing
+  OpeningBook() : first(none), max_depth(0), goal(WORST_CASE) {}
+
+  // works out every reply for the given opener, each with best_guess()
+  static OpeningBook generate(int opener, int depth, Objective objective = WORST_CASE);
+
+  bool empty() const { return replies.empty(); }
+  int opener() const { return first; }
+  int depth() const { return max_depth; }
+
+  // what the replies were chosen to minimize, which is saved with them
+  Objective objective() const { return goal; }
+
+  // The next guess after turns (guess, pattern) that began with the opener
+  // and followed the book's replies since, or -1 if the book doesn't cover
+  // that position.
+  int next_guess(const std::vector< std::pair< int, uint8_t > > & turns) const;
+
+  // returns false if the file couldn't be written
+  bool save(const std::string & filename) const;
+
+  // reads a book saved with the same word lists, or exits saying why it can't
+  static OpeningBook load(const std::string & filename);
+
+ private:
+  // the index in `replies` of the guess after the given patterns
+  static size_t slot(const uint8_t * patterns, int n);
+
+  uint16_t first;
+  int max_depth;
+  Objective goal;
+  std::vector< uint16_t > replies;
+};
+
+// The book named by the environment variable WORDLE_OPENING_BOOK, or an
+// empty one if it isn't set.
+const OpeningBook & opening_book();
+
+// The guess every solver makes after turns (guess, pattern) leave at least two
+// candidates: the opening book's reply if it has one for this objective, and
+// otherwise best_guess(), which looks in the cache before searching.
+int best_guess(const CandidateSet & candidates, const std::vector< std::pair< int, uint8_t > > & turns,
+               Objective objective = WORST_CASE);
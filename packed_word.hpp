@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "word.hpp"
+
+// A Word kept in registers: the five letters as 5-bit codes (0 for 'a') in the
+// low 25 bits of `letters`, alongside its letter_mask() and, in one nibble per
+// position, how many times that position's letter appears in the word. So
+// comparisons, hashing and per-position lookups are just integer operations,
+// and checking it against a State never has to recompute the letter mask.
+struct PackedWord {
+  uint32_t letters;
+  uint32_t mask;
+  uint32_t counts;
+
+  // the letter at position i, as 0 for 'a', 1 for 'b', ...
+  constexpr uint32_t code(int i) const { return (letters >> (5 * i)) & 31; }
+
+  constexpr char operator[](int i) const { return char('a' + code(i)); }
+
+  // how many times the letter at position i appears in the whole word
+  constexpr int count(int i) const { return int(counts >> (4 * i)) & 15; }
+
+  constexpr bool contains(char c) const { return mask & letter_mask(c); }
+};
+
+constexpr PackedWord pack(Word w) {
+  PackedWord p{0, letter_mask(w), 0};
+  for (int i = 0; i < word_length; i++) {
+    p.letters |= uint32_t(w[i] - 'a') << (5 * i);
+    uint32_t count = 0;
+    for (int j = 0; j < word_length; j++) count += (w[i] == w[j]);
+    p.counts |= count << (4 * i);
+  }
+  return p;
+}
+
+constexpr Word unpack(PackedWord p) {
+  Word w;
+  for (int i = 0; i < word_length; i++) w[i] = p[i];
+  return w;
+}
+
+// the mask and counts are derived from the letters, so they can be ignored here
+constexpr bool operator==(PackedWord a, PackedWord b) { return a.letters == b.letters; }
+constexpr bool operator!=(PackedWord a, PackedWord b) { return a.letters != b.letters; }
+constexpr bool operator<(PackedWord a, PackedWord b) { return a.letters < b.letters; }
+
+inline std::ostream & operator<<(std::ostream & out, PackedWord w) { return out << unpack(w); }
+
+static_assert(unpack(pack(Word("aloes"))) == Word("aloes"));
+static_assert(pack(Word("zebra")).code(0) == 25 && pack(Word("zebra"))[4] == 'a');
+static_assert(pack(Word("eerie")).count(0) == 3 && pack(Word("eerie")).count(2) == 1);
+
+namespace std {
+  template <>
+  struct hash< PackedWord > {
+    // 25 distinct bits fit in a size_t as-is, so one multiply is enough to spread them
+    size_t operator()(PackedWord w) const { return size_t(w.letters) * size_t(0x9E3779B97F4A7C15ull); }
+  };
+}
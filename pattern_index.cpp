@@ -0,0 +1,86 @@
+#include "pattern_index.hpp"
+
+#include "kernels.hpp"
+#include "profiler.hpp"
+
+PatternIndex::PatternIndex(WordList guesses, WordList answers) :
+  guesses(guesses), answers(answers), words_per_bitmap(uint32_t((answers.size() + 63) / 64)),
+  entries(new std::unique_ptr< Entry >[guesses.size()]), built(new std::once_flag[guesses.size()]),
+  num_built(0), bytes_used(0) {
+  if (answers.size() > CandidateSet::capacity) {
+    std::cout << "PatternIndex: too many answers (" << answers.size() << ")" << std::endl;
+    exit(1);
+  }
+}
+
+const PatternIndex::Entry & PatternIndex::entry(int guess) const {
+  std::call_once(built[guess], [this, guess](){ build(guess); });
+  return *entries[guess];
+}
+
+void PatternIndex::build(int guess) const {
+  PROFILE_ZONE("build pattern index entry");
+  size_t n = answers.size();
+
+  std::vector< uint8_t > codes(n);
+  pattern_codes(guesses[guess], answers.columns(), n, codes.data());
+
+  uint32_t counts[243]{};
+  for (auto c : codes) counts[c]++;
+
+  // a list costs 2 bytes per member, a bitmap costs 8 bytes per 64 answers
+  entries[guess] = std::make_unique< Entry >();
+  Entry & e = *entries[guess];
+  size_t listed = 0;
+  int16_t num_bitmaps = 0;
+  for (int c = 0; c < 243; c++) {
+    e.offsets[c] = uint16_t(listed);
+    if (size_t(counts[c]) * sizeof(uint16_t) > words_per_bitmap * sizeof(uint64_t)) {
+      e.bitmap[c] = num_bitmaps++;
+    } else {
+      e.bitmap[c] = -1;
+      listed += counts[c];
+    }
+  }
+  e.offsets[243] = uint16_t(listed);
+
+  e.indices.resize(listed);
+  e.bitmaps.assign(size_t(num_bitmaps) * words_per_bitmap, 0);
+
+  uint16_t next[243];
+  std::copy(e.offsets, e.offsets + 243, next);
+  for (size_t i = 0; i < n; i++) {
+    uint8_t c = codes[i];
+    if (e.bitmap[c] == -1) {
+      e.indices[next[c]++] = uint16_t(i);
+    } else {
+      e.bitmaps[size_t(e.bitmap[c]) * words_per_bitmap + i / 64] |= uint64_t(1) << (i % 64);
+    }
+  }
+
+  num_built++;
+  bytes_used += sizeof(Entry) + e.indices.size() * sizeof(uint16_t) + e.bitmaps.size() * sizeof(uint64_t);
+}
+
+CandidateSet PatternIndex::select(int guess, const CandidateSet & candidates, uint8_t code) const {
+  PROFILE_ZONE("filter candidates");
+  const Entry & e = entry(guess);
+
+  CandidateSet filtered(candidates.n);
+  if (e.bitmap[code] == -1) {
+    for (uint32_t k = e.offsets[code]; k < e.offsets[code + 1]; k++) {
+      if (candidates.contains(e.indices[k])) filtered.insert(e.indices[k]);
+    }
+  } else {
+    const uint64_t * bitmap = &e.bitmaps[size_t(e.bitmap[code]) * words_per_bitmap];
+    for (uint32_t b = 0; b < words_per_bitmap; b++) {
+      filtered.blocks[b] = candidates.blocks[b] & bitmap[b];
+    }
+  }
+  return filtered;
+}
+
+const PatternIndex & pattern_index() {
+  static const PatternIndex index(all_words, all_answers);
+  return index;
+}
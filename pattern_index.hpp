@@ -0,0 +1,57 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "lexicon.hpp"
+#include "wordle_tools.hpp"
+
+// For each guess, the set of answers that produce each of the 243 feedback
+// patterns. Filtering the candidates after a turn is then an intersection with
+// one of these sets, rather than a scan over every word.
+//
+// Each set is stored whichever way is smaller: as a bitmap over the answers,
+// or as a sorted list of 16-bit answer indices. The sets for a guess are only
+// built the first time that guess is used, so memory grows with the number of
+// distinct guesses actually played rather than the size of the lexicon.
+class PatternIndex {
+ public:
+  PatternIndex(WordList guesses, WordList answers);
+
+  // the members of candidates that produce feedback `code` for guesses[guess]
+  CandidateSet select(int guess, const CandidateSet & candidates, uint8_t code) const;
+
+  // how many guesses have been indexed so far, and the bytes they take up
+  size_t guesses_built() const { return num_built; }
+  size_t memory_usage() const { return bytes_used; }
+
+ private:
+  struct Entry {
+    // for each pattern, the position of its bitmap in `bitmaps`
+    // (in units of words_per_bitmap), or -1 if it is stored as a list
+    int16_t bitmap[243];
+
+    // the listed answers for pattern c are indices[offsets[c] .. offsets[c+1])
+    uint16_t offsets[244];
+    std::vector< uint16_t > indices;
+    std::vector< uint64_t > bitmaps;
+  };
+
+  const Entry & entry(int guess) const;
+  void build(int guess) const;
+
+  WordList guesses;
+  Lexicon answers;
+  uint32_t words_per_bitmap;
+
+  mutable std::unique_ptr< std::unique_ptr< Entry >[] > entries;
+  mutable std::unique_ptr< std::once_flag[] > built;
+  mutable std::atomic< size_t > num_built;
+  mutable std::atomic< size_t > bytes_used;
+};
+
+// the index for all_words (as guesses) against all_answers
+const PatternIndex & pattern_index();
@@ -0,0 +1,36 @@
+#include "pattern_matrix.hpp"
+
+#include "kernels.hpp"
+#include "lexicon.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+
+PatternMatrix::PatternMatrix(WordList guesses, WordList answers) :
+  num_guesses(guesses.size()), num_answers(answers.size()), codes(guesses.size() * answers.size()) {
+  PROFILE_ZONE("build pattern matrix");
+
+  // lay the answers out column-wise once, so every row can use the batch kernel
+  Lexicon columns(answers);
+
+  constexpr size_t rows_per_task = 64;
+  thread_pool().parallel_for(num_guesses, rows_per_task, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      pattern_codes(guesses[i], columns.columns(), num_answers, &codes[i * num_answers]);
+    }
+  });
+}
+
+const PatternMatrix & pattern_matrix() {
+  static const PatternMatrix patterns(all_words, all_answers);
+  return patterns;
+}
+
+CandidateSet select(PatternMatrix::Row patterns, const CandidateSet & candidates, uint8_t code) {
+  CandidateSet filtered(candidates.n);
+  for (auto i : candidates) {
+    if (patterns[i] == code) {
+      filtered.insert(i);
+    }
+  }
+  return filtered;
+}
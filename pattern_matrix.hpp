@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "wordle_tools.hpp"
+
+// a dense table of the feedback pattern for every (guess, answer) pair,
+// computed once up front so the solvers never have to call get_pattern()
+// or check() in their inner loops
+struct PatternMatrix {
+
+  // all of the patterns produced by one guess, one entry per answer
+  struct Row {
+    const uint8_t * data;
+    size_t n;
+
+    uint8_t operator[](size_t answer) const { return data[answer]; }
+    size_t size() const { return n; }
+    const uint8_t * begin() const { return data; }
+    const uint8_t * end() const { return data + n; }
+  };
+
+  // all of the patterns for one answer, one entry per guess
+  struct Column {
+    const uint8_t * data;
+    size_t n;
+    size_t stride;
+
+    uint8_t operator[](size_t guess) const { return data[guess * stride]; }
+    size_t size() const { return n; }
+  };
+
+  PatternMatrix(WordList guesses, WordList answers);
+
+  uint8_t operator()(size_t guess, size_t answer) const {
+    return codes[guess * num_answers + answer];
+  }
+
+  Row row(size_t guess) const { return Row{&codes[guess * num_answers], num_answers}; }
+
+  Column column(size_t answer) const { return Column{&codes[answer], num_guesses, num_answers}; }
+
+  size_t num_guesses;
+  size_t num_answers;
+  std::vector< uint8_t > codes;
+};
+
+// the matrix for all_words (as guesses) against all_answers,
+// built the first time it is requested
+const PatternMatrix & pattern_matrix();
+
+// the subset of candidates (indices into the matrix's answers)
+// that would have produced the given feedback for this row's guess
+CandidateSet select(PatternMatrix::Row patterns, const CandidateSet & candidates, uint8_t code);
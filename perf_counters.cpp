@@ -0,0 +1,100 @@
+#include "perf_counters.hpp"
+
+#if defined(__linux__)
+
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static int open_counter(uint32_t type, uint64_t config) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  // this thread, on whichever CPU it runs
+  return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounters::PerfCounters() {
+  fd[CYCLES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  fd[INSTRUCTIONS] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  fd[LLC_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  fd[BRANCH_MISSES] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+}
+
+PerfCounters::~PerfCounters() {
+  for (int e = 0; e < num_events; e++) {
+    if (fd[e] >= 0) close(fd[e]);
+  }
+}
+
+void PerfCounters::start() {
+  for (int e = 0; e < num_events; e++) {
+    if (fd[e] < 0) continue;
+    ioctl(fd[e], PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void PerfCounters::stop() {
+  for (int e = 0; e < num_events; e++) {
+    if (fd[e] >= 0) ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+  }
+}
+
+PerfCounters::Reading PerfCounters::read() const {
+  Reading r{};
+  for (int e = 0; e < num_events; e++) {
+    if (fd[e] < 0) continue;
+
+    uint64_t data[3]; // value, time enabled, time running
+    if (::read(fd[e], data, sizeof(data)) != ssize_t(sizeof(data))) continue;
+
+    // a counter that never got scheduled onto the PMU counted nothing useful
+    if (data[2] == 0) continue;
+
+    r.value[e] = (data[1] == data[2]) ? data[0] : uint64_t(double(data[0]) * double(data[1]) / double(data[2]));
+    r.valid[e] = true;
+  }
+  return r;
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+  for (int e = 0; e < num_events; e++) fd[e] = -1;
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+
+PerfCounters::Reading PerfCounters::read() const { return Reading{}; }
+
+#endif
+
+const char * PerfCounters::name(Event e) {
+  switch (e) {
+    case CYCLES:        return "cycles";
+    case INSTRUCTIONS:  return "instructions";
+    case LLC_MISSES:    return "llc_misses";
+    case BRANCH_MISSES: return "branch_misses";
+    default:            return "unknown";
+  }
+}
+
+bool PerfCounters::any_available() const {
+  for (int e = 0; e < num_events; e++) {
+    if (fd[e] >= 0) return true;
+  }
+  return false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// Hardware performance counters for the calling thread, via Linux's
+// perf_event_open(2). Each event is opened on its own, so whichever ones the
+// kernel refuses (no PMU in a VM or container, perf_event_paranoid set too
+// high, not Linux at all) are simply reported as unavailable.
+//
+// Only the calling thread is counted, not the thread pool's workers, so
+// benchmarks that go through the pool should run with --threads 1.
+class PerfCounters {
+ public:
+  enum Event { CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, num_events };
+
+  struct Reading {
+    uint64_t value[num_events];
+    bool valid[num_events];
+  };
+
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters & operator=(const PerfCounters &) = delete;
+
+  static const char * name(Event e);
+
+  bool available(Event e) const { return fd[e] >= 0; }
+  bool any_available() const;
+
+  // zero the counters and start counting
+  void start();
+  void stop();
+
+  // the counts between start() and stop(), scaled up if the kernel had
+  // to multiplex the counters and so only counted for part of the time
+  Reading read() const;
+
+ private:
+  int fd[num_events];
+};
@@ -0,0 +1,169 @@
+#include "profiler.hpp"
+
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace profiler {
+
+  std::atomic< bool > active{false};
+
+  thread_local int Zone::depth = 0;
+
+  namespace {
+
+    struct Event {
+      const char * name;
+      uint64_t begin;
+      uint64_t end;
+      int depth;
+    };
+
+    // Each thread's events go into a fixed-size array, so recording never
+    // reallocates and a long run can't grow without bound; once it is full,
+    // further events are only counted. The owning thread publishes each event
+    // by bumping size with a release store, so write_trace() can read the
+    // events before size while pool threads are still recording.
+    constexpr size_t max_events_per_thread = size_t(1) << 16;
+
+    struct Buffer {
+      int thread;
+      std::unique_ptr< Event[] > events{new Event[max_events_per_thread]};
+      std::atomic< size_t > size{0};
+      std::atomic< uint64_t > dropped{0};
+    };
+
+    // Buffers are only ever added to the registry, and are never freed, so
+    // that threads still running during exit (like the thread pool's) don't
+    // write into freed memory. Instead, a thread hands its buffer back to the
+    // free list when it exits and the next new thread records into it, so a
+    // server with a thread per connection keeps one buffer per concurrent
+    // thread rather than one per thread it ever ran. The tid in the trace is
+    // the buffer's, so threads that took turns with a buffer share it.
+    struct Registry {
+      std::mutex mutex;
+      std::vector< Buffer * > buffers;
+      std::vector< Buffer * > free;
+      std::string filename;
+      std::chrono::steady_clock::time_point epoch;
+    };
+
+    Registry & registry() {
+      static Registry * r = new Registry;
+      return *r;
+    }
+
+    // the calling thread's buffer, handed back when the thread exits; going
+    // through the registry's mutex orders the last owner's events before the
+    // next owner's
+    struct Lease {
+      Buffer * buffer = nullptr;
+
+      ~Lease() {
+        if (!buffer) return;
+        Registry & r = registry();
+        std::lock_guard< std::mutex > lock(r.mutex);
+        r.free.push_back(buffer);
+      }
+    };
+
+    Buffer & local_buffer() {
+      thread_local Lease lease;
+      if (!lease.buffer) {
+        Registry & r = registry();
+        std::lock_guard< std::mutex > lock(r.mutex);
+        if (!r.free.empty()) {
+          lease.buffer = r.free.back();
+          r.free.pop_back();
+        } else {
+          lease.buffer = new Buffer;
+          lease.buffer->thread = int(r.buffers.size());
+          r.buffers.push_back(lease.buffer);
+        }
+      }
+      return *lease.buffer;
+    }
+
+    void write_trace_at_exit() {
+      active = false;
+      write_trace();
+    }
+
+    // WORDLE_PROFILE=trace.json turns the profiler on for the whole run
+    const bool started_from_environment = [](){
+      if (const char * filename = std::getenv("WORDLE_PROFILE")) start(filename);
+      return true;
+    }();
+
+  }
+
+  void start(const std::string & filename) {
+    Registry & r = registry();
+    {
+      std::lock_guard< std::mutex > lock(r.mutex);
+      if (!r.filename.empty()) return;
+      r.filename = filename;
+      r.epoch = std::chrono::steady_clock::now();
+    }
+    std::atexit(write_trace_at_exit);
+    active = true;
+  }
+
+  size_t write_trace() {
+    Registry & r = registry();
+    std::lock_guard< std::mutex > lock(r.mutex);
+    if (r.filename.empty()) return 0;
+
+    std::ofstream outfile(r.filename);
+    if (!outfile) {
+      std::cerr << "profiler: could not write " << r.filename << std::endl;
+      return 0;
+    }
+
+    // complete ("X") events, with timestamps in microseconds
+    size_t count = 0;
+    uint64_t dropped = 0;
+    outfile << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    for (auto buffer : r.buffers) {
+      size_t size = buffer->size.load(std::memory_order_acquire);
+      dropped += buffer->dropped.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < size; i++) {
+        const Event & e = buffer->events[i];
+        if (count++ > 0) outfile << ",\n";
+        outfile << "{\"name\": \"" << e.name << "\", \"ph\": \"X\", \"pid\": 1";
+        outfile << ", \"tid\": " << buffer->thread;
+        outfile << ", \"ts\": " << double(e.begin) / 1000.0;
+        outfile << ", \"dur\": " << double(e.end - e.begin) / 1000.0;
+        outfile << ", \"args\": {\"depth\": " << e.depth << "}}";
+      }
+    }
+    outfile << "\n]}" << std::endl;
+
+    std::cerr << "profiler: wrote " << count << " zones to " << r.filename;
+    if (dropped > 0) std::cerr << " (" << dropped << " more dropped, buffers full)";
+    std::cerr << std::endl;
+    return count;
+  }
+
+  uint64_t now() {
+    auto elapsed = std::chrono::steady_clock::now() - registry().epoch;
+    return uint64_t(std::chrono::duration_cast< std::chrono::nanoseconds >(elapsed).count());
+  }
+
+  void record(const char * name, uint64_t begin, uint64_t end, int depth) {
+    if (!enabled()) return;
+    Buffer & buffer = local_buffer();
+    size_t size = buffer.size.load(std::memory_order_relaxed);
+    if (size == max_events_per_thread) {
+      buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    buffer.events[size] = Event{name, begin, end, depth};
+    buffer.size.store(size + 1, std::memory_order_release);
+  }
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// A scoped profiler for finding out where a slow turn spent its time.
+//
+// Each PROFILE_ZONE("name") records how long the rest of its enclosing scope
+// took, into a buffer owned by the current thread, so zones nest naturally
+// and threads never contend. Nothing is recorded until the profiler is
+// started, either with profiler::start() or by setting WORDLE_PROFILE to a
+// filename, and until then a zone costs one relaxed load. Each thread keeps
+// at most 65536 zones and drops the rest, and a thread's buffer is reused by
+// later threads once it exits. At exit, or whenever write_trace() is called,
+// every thread's zones are written out in the Chrome trace event format,
+// which chrome://tracing, Perfetto and speedscope all read.
+namespace profiler {
+
+  extern std::atomic< bool > active;
+
+  inline bool enabled() { return active.load(std::memory_order_relaxed); }
+
+  // start recording, and write the trace to filename at exit
+  void start(const std::string & filename);
+
+  // writes the zones recorded so far, while recording carries on, and
+  // returns how many were written; does nothing unless the profiler started
+  size_t write_trace();
+
+  // nanoseconds on a steady clock, since the profiler was started
+  uint64_t now();
+
+  void record(const char * name, uint64_t begin, uint64_t end, int depth);
+
+  class Zone {
+   public:
+    explicit Zone(const char * name) : name(name), begin(0), recording(enabled()) {
+      if (recording) {
+        begin = now();
+        depth++;
+      }
+    }
+
+    ~Zone() {
+      if (recording) record(name, begin, now(), --depth);
+    }
+
+    Zone(const Zone &) = delete;
+    Zone & operator=(const Zone &) = delete;
+
+   private:
+    const char * name; // must outlive the profiler, i.e. a string literal
+    uint64_t begin;
+    bool recording;
+
+    static thread_local int depth;
+  };
+
+}
+
+#define PROFILE_CONCATENATE_(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_(a, b)
+#define PROFILE_ZONE(name) profiler::Zone PROFILE_CONCATENATE(profile_zone_, __LINE__)(name)
@@ -0,0 +1,88 @@
+#include "scoring.hpp"
+
+#include "kernels.hpp"
+
+#include <cmath>
+
+Histogram histogram(PatternMatrix::Row patterns, const CandidateSet & candidates) {
+  Histogram counts{};
+  for (auto i : candidates) counts[patterns[i]]++;
+  return counts;
+}
+
+Histogram histogram(Word guess, const Lexicon & answers) {
+  thread_local std::vector< uint8_t > codes;
+  codes.resize(answers.size());
+  pattern_codes(guess, answers.columns(), answers.size(), codes.data());
+
+  Histogram counts{};
+  for (auto code : codes) counts[code]++;
+  return counts;
+}
+
+namespace {
+
+  // n log2(n) for every possible bucket size, since log2f() would
+  // otherwise dominate scoring a small set of candidates
+  const float * n_log_n_table() {
+    static const std::vector< float > table = [](){
+      std::vector< float > t(CandidateSet::capacity + 1, 0.0f);
+      for (uint32_t i = 1; i < t.size(); i++) t[i] = i * log2f(float(i));
+      return t;
+    }();
+    return table.data();
+  }
+
+  struct Totals {
+    const float * n_log_n = n_log_n_table();
+    uint32_t total = 0;
+    uint32_t largest = 0;
+    uint64_t sum_of_squares = 0;
+    float sum_n_log_n = 0.0f;
+
+    void add(uint32_t n) {
+      total += n;
+      largest = std::max(largest, n);
+      sum_of_squares += uint64_t(n) * n;
+      sum_n_log_n += n_log_n[n];
+    }
+
+    // with N candidates split into buckets of size n_i:
+    //   E[bucket size] = sum_i (n_i / N) * n_i
+    //   entropy        = -sum_i (n_i / N) log2(n_i / N) = log2(N) - sum_i n_i log2(n_i) / N
+    Score score() const {
+      if (total == 0) return Score{0, 0.0f, 0.0f};
+      float N = float(total);
+      return Score{largest, sum_of_squares / N, log2f(N) - sum_n_log_n / N};
+    }
+  };
+
+}
+
+Score score(const Histogram & counts) {
+  Totals t;
+  for (auto n : counts) {
+    if (n > 0) t.add(n);
+  }
+  return t.score();
+}
+
+Score score(const uint8_t * codes, size_t n) {
+
+  // only the entries for patterns that actually occur are ever read
+  uint32_t counts[num_patterns];
+  for (size_t i = 0; i < n; i++) counts[codes[i]] = 0;
+  for (size_t i = 0; i < n; i++) counts[codes[i]]++;
+
+  // buckets are visited in order of first appearance rather than by pattern,
+  // so entropies can differ from score(Histogram) in the last bit or so
+  Totals t;
+  for (size_t i = 0; i < n; i++) {
+    uint32_t & count = counts[codes[i]];
+    if (count == 0) continue;
+    t.add(count);
+    count = 0;
+  }
+  return t.score();
+
+}
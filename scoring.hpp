@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "lexicon.hpp"
+#include "pattern_matrix.hpp"
+
+// how many of the candidates fall into each feedback pattern for a given guess
+using Histogram = std::array< uint32_t, num_patterns >;
+
+Histogram histogram(PatternMatrix::Row patterns, const CandidateSet & candidates);
+
+// for when there's no precomputed matrix, this computes the patterns on the fly
+Histogram histogram(Word guess, const Lexicon & answers);
+
+struct Score {
+  uint32_t worst_case;  // size of the largest bucket
+  float expected_size;  // size of the bucket the answer lands in, on average
+  float entropy;        // information gained by the guess, in bits
+
+  // a quantity to minimize for the given objective
+  float cost(Objective objective) const {
+    if (objective == WORST_CASE) return float(worst_case);
+    if (objective == EXPECTED_SIZE) return expected_size;
+    return -entropy;
+  }
+};
+
+// all of the scores come out of a single pass over the histogram
+Score score(const Histogram & counts);
+
+inline Score score(PatternMatrix::Row patterns, const CandidateSet & candidates) {
+  return score(histogram(patterns, candidates));
+}
+
+// The same scores for a handful of candidates, from their n feedback codes.
+// This only touches the buckets the candidates land in, which for small sets
+// is much cheaper than clearing and scanning a whole histogram.
+Score score(const uint8_t * codes, size_t n);
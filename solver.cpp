@@ -1,62 +1,228 @@
 #include <array>
+#include <memory>
+#include <string>
+#include <fstream>
 #include <vector>
 #include <iostream>
 #include <algorithm>
 
 #include "wordle_tools.hpp"
+#include "thread_pool.hpp"
+#include "pattern_index.hpp"
+#include "pattern_matrix.hpp"
+#include "tree_search.hpp"
+#include "decision_tree.hpp"
+#include "timer.hpp"
+#include "profiler.hpp"
+#include "solver_daemon.hpp"
 
-bool hard_mode = true;
+void usage() {
+  std::cout << "usage: solver [--threads N] [--tree FILE] [--answers FILE] [answer]" << std::endl;
+  std::cout << "       solver --optimal [--breadth K] [--worst-case] [--first WORD] [--save FILE]" << std::endl;
+  std::cout << "       solver --serve [--socket PATH] [--threads N]" << std::endl;
+  exit(1);
+}
 
-int main(int argc, char * argv[]) {
+// plays by following a precomputed tree, returning the number of
+// guesses it took or -1 if the tree doesn't cover this answer
+int tree_solve(const MappedTree & tree, Word answer, bool debug_print = false) {
+  PROFILE_ZONE("solve game from tree");
+  MappedTree::Node node = MappedTree::root;
+  for (int guesses = 1; guesses < 10; guesses++) {
+    Word guess = all_words[tree.guess(node)];
+    uint8_t pattern = get_pattern(answer, guess);
+    if (debug_print) print(decode(pattern), guess);
+    if (pattern == all_green) return guesses;
+    node = tree.next(node, pattern);
+    if (node == MappedTree::none) return -1;
+  }
+  return -1;
+}
 
-  Word answer = random(all_answers);
+std::vector< Word > read_words(const std::string & filename) {
+  PROFILE_ZONE("read words");
+  std::ifstream infile(filename);
+  if (!infile) {
+    std::cout << "could not open " << filename << std::endl;
+    exit(1);
+  }
+  std::vector< Word > words;
+  std::string word;
+  while (infile >> word) words.push_back(Word(word));
+  return words;
+}
 
-  int num_guesses = 0;
+// solves every answer across the thread pool, without any output per game
+void solve_all(const std::vector< Word > & answers, const MappedTree * tree) {
 
-  while (num_guesses < 6) {
-    std::string guess;
-    std::getline(std::cin, guess);
-    delete_line();
-    if (guess.size() == word_length) {
-      auto clues = get_clues(answer, guess);
-      print(clues, guess);
-      num_guesses++;
+  // each thread counts its own games, so the tallies need no synchronization
+  constexpr int max_guesses = 10;
+  struct alignas(64) Tally {
+    uint64_t counts[max_guesses];
+    uint64_t failures;
 
-      if (clues == std::array{GREEN, GREEN, GREEN, GREEN, GREEN}) break;
+    void record(int guesses) {
+      if (guesses < 0 || guesses >= max_guesses) {
+        failures++;
+      } else {
+        counts[guesses]++;
+      }
     }
+  };
+  ThreadPool & pool = thread_pool();
+  std::vector< Tally > tallies(pool.size(), Tally{});
+
+  // the games are spread across the pool, and any guess scoring they need
+  // runs serially inside them, so only this level is parallel
+  double seconds = runtime([&](){
+    pool.parallel_for(answers.size(), 1, [&](size_t begin, size_t end) {
+      Tally & local = tallies[pool.thread_id()];
+      for (size_t i = begin; i < end; i++) {
+        local.record(tree ? tree_solve(*tree, answers[i]) : wordle_solve(answers[i]));
+      }
+    });
+  });
+
+  Tally total{};
+  for (auto & t : tallies) {
+    for (int i = 0; i < max_guesses; i++) total.counts[i] += t.counts[i];
+    total.failures += t.failures;
   }
 
-  if (num_guesses < 6) {
-    std::cout << "🎉🎉🎉🎉🎉" << std::endl;
-  } else {
-    std::cout << "too bad, the answer was: " << answer << std::endl;
+  uint64_t solved = 0, guesses = 0;
+  int most = 0;
+  for (int i = 0; i < max_guesses; i++) {
+    std::cout << i << ": " << total.counts[i] << std::endl;
+    solved += total.counts[i];
+    guesses += i * total.counts[i];
+    if (total.counts[i] > 0) most = i;
+  }
+  std::cout << "failed: " << total.failures << std::endl;
+  std::cout << "mean: " << (solved ? double(guesses) / solved : 0.0) << std::endl;
+  std::cout << "max: " << most << std::endl;
+  std::cout << answers.size() << " games in " << seconds << "s on " << pool.size() << " threads" << std::endl;
+
+}
+
+void solve_optimal(SearchOptions options, const std::string & save_file) {
+  TreeSearch search(pattern_matrix(), options);
+  DecisionTree tree = search.solve(CandidateSet::all(all_answers.size()));
+  if (tree.nodes.empty()) {
+    std::cout << "no strategy within " << options.max_guesses << " guesses" << std::endl;
+    exit(1);
+  }
+
+  const SearchStats & stats = search.stats();
+  std::cout << "first guess: " << all_words[tree.nodes[0].guess] << std::endl;
+  std::cout << "total guesses: " << tree.total_guesses << " (";
+  std::cout << double(tree.total_guesses) / all_answers.size() << " on average)" << std::endl;
+  std::cout << "max guesses: " << tree.max_guesses << std::endl;
+  std::cout << "tree nodes: " << tree.nodes.size() << std::endl;
+  std::cout << "searched " << stats.nodes << " nodes in " << stats.seconds << "s (";
+  std::cout << uint64_t(stats.nodes_per_second()) << " nodes/s), ";
+  std::cout << stats.table_hits << " table hits, " << search.table_size() << " table entries" << std::endl;
+
+  if (!save_file.empty()) {
+    if (!write_tree(tree, save_file)) {
+      std::cout << "could not write " << save_file << std::endl;
+      exit(1);
+    }
+    std::cout << "saved to " << save_file << std::endl;
   }
+}
 
+int main(int argc, char * argv[]) {
 
-#if 0
-  auto possible_words = all_words;
+  std::vector< std::string > words;
+  bool optimal = false;
+  bool serve = false;
+  std::string socket_path;
+  SearchOptions options;
+  std::string save_file;
+  std::unique_ptr< MappedTree > tree;
+  std::vector< Word > answers(all_answers.begin(), all_answers.end());
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--threads") {
+      if (i + 1 == argc) usage();
+      int n = std::atoi(argv[++i]);
+      if (n <= 0) usage();
+      set_num_threads(n);
+    } else if (arg == "--optimal") {
+      optimal = true;
+    } else if (arg == "--serve") {
+      serve = true;
+    } else if (arg == "--socket") {
+      if (i + 1 == argc) usage();
+      socket_path = argv[++i];
+    } else if (arg == "--breadth") {
+      if (i + 1 == argc) usage();
+      options.breadth = std::atoi(argv[++i]);
+      if (options.breadth < 0) usage();
+    } else if (arg == "--worst-case") {
+      options.cost = MAX_GUESSES;
+    } else if (arg == "--first") {
+      if (i + 1 == argc) usage();
+      options.first_guess = index_of(all_words, Word(std::string(argv[++i])));
+      if (options.first_guess < 0) {
+        std::cout << argv[i] << " is not a valid guess" << std::endl;
+        exit(1);
+      }
+    } else if (arg == "--save") {
+      if (i + 1 == argc) usage();
+      save_file = argv[++i];
+    } else if (arg == "--answers") {
+      if (i + 1 == argc) usage();
+      answers = read_words(argv[++i]);
+    } else if (arg == "--tree") {
+      if (i + 1 == argc) usage();
+      tree = std::make_unique< MappedTree >(argv[++i]);
+    } else {
+      words.push_back(arg);
+    }
+  }
 
-  State clues{};
+  if (words.size() > 1) usage();
+  if (!save_file.empty() && !optimal) usage();
+
+  if (!socket_path.empty() && !serve) usage();
+
+  if (serve) {
+    if (optimal || !words.empty() || tree) usage();
+    SolverDaemon daemon;
+    if (socket_path.empty()) {
+      daemon.serve(std::cin, std::cout);
+    } else {
+      daemon.serve_socket(socket_path);
+    }
+    return 0;
+  }
 
-  if (argc == 2) { 
-    std::string answer = argv[1];
+  if (optimal) {
+    if (!words.empty() || tree) usage();
+    solve_optimal(options, save_file);
+    return 0;
+  }
+
+  if (words.size() == 1) {
+    std::string answer = words[0];
     if (answer.size() != 5) {
       std::cout << "must enter a 5-letter word" << std::endl;
       exit(1);
     }
     bool debug_print;
-    wordle_solve(answer, debug_print = true);
-  } else {
-
-    int counts[10]{};
-    for (auto word : all_words) {
-      counts[wordle_solve(word)]++;
+    if (tree) {
+      int guesses = tree_solve(*tree, answer, debug_print = true);
+      if (guesses < 0) std::cout << "the tree doesn't cover " << answer << std::endl;
+      return 0;
     }
+    wordle_solve(answer, debug_print = true);
 
-    for (int i = 0; i < 10; i++) {
-      std::cout << i << ": " << counts[i] << std::endl;
-    }
+    const PatternIndex & index = pattern_index();
+    std::cout << "pattern index: " << index.guesses_built() << " guesses, ";
+    std::cout << index.memory_usage() / 1024 << " KiB" << std::endl;
+  } else {
+    solve_all(answers, tree.get());
   }
-#endif
 
 }
@@ -0,0 +1,287 @@
+#include "solver_daemon.hpp"
+
+#include "wordle_tools.hpp"
+#include "word_index.hpp"
+#include "guess_cache.hpp"
+#include "opening_book.hpp"
+#include "pattern_index.hpp"
+#include "pattern_matrix.hpp"
+#include "profiler.hpp"
+#include "stop_signal.hpp"
+
+#include <array>
+#include <cerrno>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+SolverDaemon::SolverDaemon() : num_requests(0), total_nanoseconds(0), max_nanoseconds(0), num_connections(0) {
+  PROFILE_ZONE("start daemon");
+  pattern_matrix();
+  words_index();
+  pattern_index();
+  guess_cache();
+  opening_book();
+
+  // the second guesses are by far the slowest to search for, so every one
+  // is worked out now, unless the opening book already has them
+  int opener = opening_guess();
+  const OpeningBook & book = opening_book();
+  if (book.empty() || book.opener() != opener || book.objective() != WORST_CASE) {
+    PROFILE_ZONE("warm second guesses");
+    const CandidateSet all = CandidateSet::all(all_answers.size());
+    for (size_t p = 0; p < num_patterns; p++) {
+      CandidateSet candidates = pattern_index().select(opener, all, uint8_t(p));
+      if (candidates.size() >= 2) best_guess(candidates);
+    }
+  }
+
+  started = std::chrono::steady_clock::now();
+}
+
+static std::string text(Word w) { return std::string(w.data, word_length); }
+
+// feedback as the client writes it, e.g. "gybbb", or -1 if it isn't valid
+static int parse_feedback(const std::string & s) {
+  if (s.size() != word_length) return -1;
+  std::array< Clue, 5 > clues{};
+  for (int i = 0; i < word_length; i++) {
+    if (s[i] == 'g') clues[i] = GREEN;
+    else if (s[i] == 'y') clues[i] = YELLOW;
+    else if (s[i] == 'b') clues[i] = GRAY;
+    else return -1;
+  }
+  return encode(clues);
+}
+
+std::string SolverDaemon::next_guess(const std::string & request) {
+  PROFILE_ZONE("daemon request");
+
+  std::istringstream tokens(request);
+  std::string guess, feedback;
+  std::vector< std::pair< int, uint8_t > > turns;
+  while (tokens >> guess) {
+    if (!(tokens >> feedback)) return "err expected feedback after " + guess;
+    int index = (guess.size() == word_length) ? words_index().find(Word(guess)) : -1;
+    if (index < 0) return "err " + guess + " is not a valid guess";
+    int code = parse_feedback(feedback);
+    if (code < 0) return "err " + feedback + " is not valid feedback (use g, y and b)";
+    turns.push_back({index, uint8_t(code)});
+  }
+
+  CandidateSet candidates = CandidateSet::all(all_answers.size());
+  if (turns.empty()) {
+    return "ok " + text(all_words[opening_guess()]) + " " + std::to_string(candidates.size());
+  }
+
+  for (auto [index, code] : turns) {
+    candidates = pattern_index().select(index, candidates, code);
+  }
+
+  // the same policy as wordle_solve(): once a single answer is left, guess it
+  size_t remaining = candidates.size();
+  if (remaining == 0) return "err no answers fit that feedback";
+  if (remaining == 1) return "ok " + text(all_answers[candidates.first()]) + " 1";
+
+  return "ok " + text(all_words[best_guess(candidates, turns)]) + " " + std::to_string(remaining);
+}
+
+std::string SolverDaemon::stats() {
+  double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - started).count();
+  uint64_t n = num_requests;
+  std::ostringstream out;
+  out << "ok requests " << n;
+  out << " per_second " << (seconds > 0 ? n / seconds : 0.0);
+  out << " mean_us " << (n ? total_nanoseconds / 1e3 / n : 0.0);
+  out << " max_us " << max_nanoseconds / 1e3;
+  out << " uptime_s " << seconds;
+  GuessCacheStats cache = guess_cache().stats();
+  out << " cache_hits " << cache.hits << " cache_misses " << cache.misses << " cache_size " << cache.size;
+  return out.str();
+}
+
+std::string SolverDaemon::respond(const std::string & request) {
+  if (request == "stats") return stats();
+  if (request == "profile") {
+    if (!profiler::enabled()) return "err profiler is off";
+    return "ok zones " + std::to_string(profiler::write_trace());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::string response = next_guess(request);
+  uint64_t ns = std::chrono::duration_cast< std::chrono::nanoseconds >(std::chrono::steady_clock::now() - start).count();
+
+  num_requests++;
+  total_nanoseconds += ns;
+  uint64_t longest = max_nanoseconds;
+  while (ns > longest && !max_nanoseconds.compare_exchange_weak(longest, ns)) {}
+
+  return response;
+}
+
+void SolverDaemon::serve(std::istream & in, std::ostream & out) {
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line == "quit") break;
+    out << respond(line) << '\n' << std::flush;
+  }
+}
+
+// longer than any valid request, and the most kept of a line still coming in
+constexpr size_t max_line = 256;
+
+// writes all of data, returning false if the client has gone away
+static bool write_all(int fd, const std::string & data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    written += size_t(n);
+  }
+  return true;
+}
+
+void SolverDaemon::serve_connection(int fd) {
+  std::string pending;
+  bool discarding = false; // skipping the rest of a line that was too long
+  char buffer[4096];
+  while (true) {
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    pending.append(buffer, size_t(n));
+
+    // answer every complete line, leaving any partial one for the next read
+    size_t begin = 0, end;
+    std::string responses;
+    bool quit = false;
+    while (!quit && (end = pending.find('\n', begin)) != std::string::npos) {
+      std::string line = pending.substr(begin, end - begin);
+      begin = end + 1;
+      if (discarding) {
+        discarding = false;
+        continue;
+      }
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      if (line.size() > max_line) responses += "err line too long\n";
+      else if (line == "quit") quit = true;
+      else responses += respond(line) + '\n';
+    }
+    pending.erase(0, begin);
+
+    // a partial line can't grow without bound: it is answered now, and the
+    // rest of it is dropped as it arrives
+    if (pending.size() > max_line) {
+      if (!discarding) responses += "err line too long\n";
+      discarding = true;
+      pending.clear();
+    }
+
+    if (!write_all(fd, responses) || quit) break;
+  }
+}
+
+void SolverDaemon::serve_socket(const std::string & path, int max_connections) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "socket path is too long: " << path << std::endl;
+    exit(1);
+  }
+  std::strcpy(address.sun_path, path.c_str());
+
+  // non-blocking, so that accept() only ever takes a connection that poll()
+  // has seen waiting, and never blocks with the reserve descriptor given up
+  int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  unlink(path.c_str());
+  if (listener < 0 || bind(listener, (sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+    std::cerr << "could not listen on " << path << ": " << std::strerror(errno) << std::endl;
+    exit(1);
+  }
+  std::cerr << "listening on " << path << std::endl;
+
+  // given up to turn a client away when out of descriptors, as in GameServer
+  int reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+  int stop = stop_signal();
+  while (!stop_requested()) {
+    {
+      // woken now and then to check for a stop, which can't notify us itself
+      std::unique_lock< std::mutex > lock(connections_mutex);
+      if (num_connections >= max_connections) {
+        connection_closed.wait_for(lock, std::chrono::milliseconds(100));
+        continue;
+      }
+    }
+
+    pollfd waiting[2] = {{listener, POLLIN, 0}, {stop, POLLIN, 0}};
+    if (poll(waiting, 2, -1) < 0 && errno != EINTR) {
+      std::cerr << "poll failed: " << std::strerror(errno) << std::endl;
+      exit(1);
+    }
+    if (waiting[1].revents) break;
+
+    int fd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EMFILE || errno == ENFILE) {
+        if (reserve_fd >= 0) {
+          close(reserve_fd);
+          fd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+          if (fd >= 0) {
+            write_all(fd, "err server full\n");
+            close(fd);
+          }
+          reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        } else {
+          // with no reserve, wait for a connection to close and free one
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        continue;
+      }
+
+      // the client went away while queued, or something else that won't last
+      if (errno == EAGAIN || errno == EINTR || errno == ECONNABORTED || errno == EPROTO ||
+          errno == ENOBUFS || errno == ENOMEM) {
+        continue;
+      }
+      std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+      exit(1);
+    }
+
+    {
+      std::lock_guard< std::mutex > lock(connections_mutex);
+      num_connections++;
+      connection_fds.insert(fd);
+    }
+    std::thread([this, fd](){
+      serve_connection(fd);
+
+      // closed under the lock, so that stopping never shuts down a
+      // descriptor that has since been reused
+      std::lock_guard< std::mutex > lock(connections_mutex);
+      connection_fds.erase(fd);
+      close(fd);
+      num_connections--;
+      connection_closed.notify_all();
+    }).detach();
+  }
+
+  // stop taking connections, hang up on the open ones (a search in progress
+  // still finishes), and wait for their threads to be done with them
+  close(listener);
+  unlink(path.c_str());
+  if (reserve_fd >= 0) close(reserve_fd);
+  std::unique_lock< std::mutex > lock(connections_mutex);
+  for (int fd : connection_fds) shutdown(fd, SHUT_RDWR);
+  connection_closed.wait(lock, [&](){ return num_connections == 0; });
+  std::cerr << "stopped" << std::endl;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <cstdint>
+#include <condition_variable>
+#include <iostream>
+
+// A long-running solver that answers one request per line, so that a client
+// playing many games pays for loading the word lists and pattern tables once
+// rather than once per game.
+//
+// A request is the game so far, as pairs of a guess and its feedback (five of
+// g, y or b for green, yellow and gray), e.g. "aloes bybbb tripe bbygb", and
+// the response is "ok", the next guess and the number of answers that still
+// fit, e.g. "ok crust 12". An empty request gets the opening guess. Bad
+// requests get "err" followed by a message. "stats" reports the requests
+// served so far, also after "ok", "profile" writes out the profiler's trace
+// so far when WORDLE_PROFILE is set, and "quit" ends the session.
+//
+// Every reply to the opening guess is worked out at startup, so the second
+// guess, which has the most answers left to split, is never searched for on
+// a request. Later guesses that aren't cached yet take milliseconds.
+class SolverDaemon {
+ public:
+  // loads everything up front, so the first request is as fast as the rest
+  SolverDaemon();
+
+  // the response to a single line, without its newline
+  std::string respond(const std::string & request);
+
+  // serves lines from in until it ends or says "quit"
+  void serve(std::istream & in, std::ostream & out);
+
+  // serves each connection to a Unix domain socket at path on its own thread,
+  // until the process gets SIGINT or SIGTERM; at most max_connections are
+  // served at once, and any more wait to be accepted until one closes
+  void serve_socket(const std::string & path, int max_connections = 64);
+
+ private:
+  std::string next_guess(const std::string & request);
+  std::string stats();
+  void serve_connection(int fd);
+
+  std::chrono::steady_clock::time_point started;
+  std::atomic< uint64_t > num_requests;
+  std::atomic< uint64_t > total_nanoseconds;
+  std::atomic< uint64_t > max_nanoseconds;
+
+  std::mutex connections_mutex;
+  std::condition_variable connection_closed;
+  int num_connections;
+  std::set< int > connection_fds;
+};
@@ -0,0 +1,48 @@
+#include "stop_signal.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+  int pipe_fds[2] = {-1, -1};
+  volatile std::sig_atomic_t requested = 0;
+
+  void on_signal(int) {
+    int saved = errno;
+    requested = 1;
+    char byte = 1;
+    ssize_t ignored = write(pipe_fds[1], &byte, 1);
+    (void)ignored;
+    errno = saved;
+  }
+
+}
+
+int stop_signal() {
+  static const int fd = [](){
+    if (pipe2(pipe_fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+      std::cerr << "pipe2: " << std::strerror(errno) << std::endl;
+      exit(1);
+    }
+
+    // SA_RESTART, so that other threads' blocking calls carry on as usual
+    struct sigaction action{};
+    action.sa_handler = on_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    return pipe_fds[0];
+  }();
+  return fd;
+}
+
+bool stop_requested() {
+  return requested != 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// Lets a server that would otherwise run until it is killed stop cleanly on
+// SIGINT or SIGTERM instead, so that what the program writes at exit (the
+// guess cache, a profiler trace) still gets written. The handler only writes
+// a byte to a pipe, so a server notices by watching stop_signal() alongside
+// its sockets, whichever thread the signal happened to interrupt.
+
+// installs the handlers on first use, and returns a descriptor that becomes
+// readable once either signal has arrived
+int stop_signal();
+
+// whether either signal has arrived yet
+bool stop_requested();
@@ -0,0 +1,130 @@
+#include "thread_pool.hpp"
+
+namespace {
+  thread_local const ThreadPool * current_pool = nullptr;
+  thread_local int current_id = -1;
+  thread_local int task_depth = 0;
+}
+
+ThreadPool::ThreadPool(int num_threads) : queued(0), stop(false) {
+  int num_workers = std::max(num_threads, 1) - 1;
+
+  // one queue per worker, plus a shared one for outside threads
+  for (int i = 0; i < num_workers + 1; i++) {
+    queues.push_back(std::make_unique< Queue >());
+  }
+
+  for (int i = 0; i < num_workers; i++) {
+    workers.emplace_back([this, i](){ worker_loop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard< std::mutex > lock(sleep_mutex);
+    stop = true;
+  }
+  wake.notify_all();
+  for (auto & worker : workers) worker.join();
+}
+
+int ThreadPool::thread_id() const {
+  return (current_pool == this) ? current_id : int(workers.size());
+}
+
+bool ThreadPool::in_task() const {
+  return task_depth > 0;
+}
+
+void ThreadPool::run(TaskGroup & group, Task task) {
+  group.pending++;
+
+  Queue & q = *queues[thread_id()];
+  {
+    std::lock_guard< std::mutex > lock(q.mutex);
+    q.tasks.push_front([&group, task = std::move(task)](){
+      task_depth++;
+      task();
+      task_depth--;
+      group.pending--;
+    });
+  }
+
+  queued++;
+  {
+    std::lock_guard< std::mutex > lock(sleep_mutex);
+  }
+  wake.notify_one();
+}
+
+bool ThreadPool::try_pop(int id, Task & task) {
+
+  // newest work from our own queue first, since it is likely still in cache ...
+  {
+    Queue & q = *queues[id];
+    std::lock_guard< std::mutex > lock(q.mutex);
+    if (!q.tasks.empty()) {
+      task = std::move(q.tasks.front());
+      q.tasks.pop_front();
+      queued--;
+      return true;
+    }
+  }
+
+  // ... otherwise steal the oldest (typically largest) work from someone else
+  int n = int(queues.size());
+  for (int i = 1; i < n; i++) {
+    Queue & q = *queues[(id + i) % n];
+    std::lock_guard< std::mutex > lock(q.mutex);
+    if (!q.tasks.empty()) {
+      task = std::move(q.tasks.back());
+      q.tasks.pop_back();
+      queued--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::wait(TaskGroup & group) {
+  int id = thread_id();
+  Task task;
+  while (group.pending > 0) {
+    if (try_pop(id, task)) {
+      task();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void ThreadPool::worker_loop(int id) {
+  current_pool = this;
+  current_id = id;
+
+  Task task;
+  while (true) {
+    if (try_pop(id, task)) {
+      task();
+    } else {
+      std::unique_lock< std::mutex > lock(sleep_mutex);
+      wake.wait(lock, [this](){ return stop || queued > 0; });
+      if (stop && queued == 0) return;
+    }
+  }
+}
+
+static int requested_threads = 0;
+
+void set_num_threads(int n) { requested_threads = n; }
+
+int num_threads() {
+  if (requested_threads > 0) return requested_threads;
+  return std::max(int(std::thread::hardware_concurrency()), 1);
+}
+
+ThreadPool & thread_pool() {
+  static ThreadPool pool(num_threads());
+  return pool;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+// A fixed set of worker threads, each with its own deque of tasks. Workers take
+// work from the front of their own deque and, when it runs dry, steal from the
+// back of the others'. Threads that wait on a TaskGroup help execute tasks
+// instead of blocking, so waiting from inside a task is safe.
+class ThreadPool {
+ public:
+  using Task = std::function< void() >;
+
+  struct TaskGroup {
+    std::atomic< int > pending{0};
+  };
+
+  // num_threads counts the calling thread, which participates in wait()
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  // total number of threads doing work, including the caller
+  int size() const { return int(workers.size()) + 1; }
+
+  void run(TaskGroup & group, Task task);
+  void wait(TaskGroup & group);
+
+  // calls f(begin, end) on chunks of [0, n) and returns once they are all done
+  template < typename callable >
+  void parallel_for(size_t n, size_t chunk_size, callable f) {
+    TaskGroup group;
+    for (size_t begin = 0; begin < n; begin += chunk_size) {
+      size_t end = std::min(begin + chunk_size, n);
+      run(group, [=, &f](){ f(begin, end); });
+    }
+    wait(group);
+  }
+
+  // An index in [0, size()) identifying the current thread, where worker
+  // threads are numbered first and every outside thread gets size() - 1. So
+  // state kept per thread_id() is only safe with a single outside caller;
+  // code that other threads may call at the same time should reduce within
+  // each task instead, as best_guess_brute_force() does.
+  int thread_id() const;
+
+  // whether the calling thread is in the middle of running a task, so that
+  // work nested inside one can run serially instead of splitting up again
+  bool in_task() const;
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque< Task > tasks;
+  };
+
+  bool try_pop(int id, Task & task);
+  void worker_loop(int id);
+
+  std::vector< std::thread > workers;
+  std::vector< std::unique_ptr< Queue > > queues;
+
+  std::atomic< int > queued;
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stop;
+};
+
+// the number of threads used by the solvers, defaulting to
+// std::thread::hardware_concurrency(); must be set before the
+// first call to thread_pool()
+void set_num_threads(int n);
+int num_threads();
+
+ThreadPool & thread_pool();
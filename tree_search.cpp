@@ -0,0 +1,331 @@
+#include "tree_search.hpp"
+
+#include "timer.hpp"
+#include "thread_pool.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+
+TreeSearch::TreeSearch(const PatternMatrix & patterns, SearchOptions options) :
+  patterns(patterns), options(options), seconds(0), counters(thread_pool().size(), Counters{0, 0}), answer_guess(patterns.num_answers, -1), root_guess(-1) {
+
+  // an answer can only be confirmed by guessing it, which is the
+  // one guess that comes back all green
+  for (size_t a = 0; a < patterns.num_answers; a++) {
+    auto column = patterns.column(a);
+    for (size_t g = 0; g < column.size(); g++) {
+      if (column[g] == all_green) { answer_guess[a] = int(g); break; }
+    }
+  }
+}
+
+int TreeSearch::lower_bound(size_t n) const {
+  if (n == 0) return 0;
+  if (options.cost == TOTAL_GUESSES) {
+    // at best, one answer is guessed right away and the rest on the next turn
+    return int(2 * n - 1);
+  } else {
+    return (n == 1) ? 1 : 2;
+  }
+}
+
+TreeSearch::Key TreeSearch::key(const CandidateSet & candidates, int guesses_left) const {
+  return Key{{hash(candidates, 0), hash(candidates, 0x5851F42D4C957F2Dull)}, guesses_left};
+}
+
+void TreeSearch::Best::update(int new_cost, int new_guess) {
+  std::lock_guard< std::mutex > lock(mutex);
+  if (new_cost < cost) {
+    cost = new_cost;
+    guess = new_guess;
+  }
+}
+
+bool TreeSearch::lookup(const Key & k, Entry & e) {
+  Shard & shard = table[k.fingerprint[1] % num_shards];
+  std::lock_guard< std::mutex > lock(shard.mutex);
+  auto it = shard.entries.find(k);
+  if (it == shard.entries.end()) return false;
+  e = it->second;
+  return true;
+}
+
+void TreeSearch::store(const Key & k, int cost, int guess) {
+  Shard & shard = table[k.fingerprint[1] % num_shards];
+  std::lock_guard< std::mutex > lock(shard.mutex);
+  Entry & e = shard.entries.emplace(k, Entry{0, -1, -1}).first->second;
+  if (guess >= 0) {
+    e.cost = cost;
+    e.guess = guess;
+  } else {
+    e.lower_bound = std::max(e.lower_bound, cost);
+  }
+}
+
+int TreeSearch::search(const CandidateSet & candidates, int guesses_left, int budget, int only_guess) {
+
+  size_t n = candidates.size();
+  if (n == 0) return 0;
+  if (guesses_left <= 0) return infinity;
+  if (n == 1) return answer_guess[candidates.first()] >= 0 ? 1 : infinity;
+  if (guesses_left == 1) return infinity;
+
+  bool memoized = (only_guess < 0);
+
+  // for a pair, guessing either one of them is as good as it gets
+  if (n == 2 && memoized) {
+    int a = candidates.first();
+    int b = *++candidates.begin();
+    if (answer_guess[a] >= 0 && answer_guess[b] >= 0) return lower_bound(2);
+  }
+
+  int fewest = lower_bound(n);
+  if (budget <= fewest) return fewest;
+
+  ThreadPool & pool = thread_pool();
+  Counters & local = counters[pool.thread_id()];
+
+  Key k = key(candidates, guesses_left);
+  if (memoized) {
+    Entry e;
+    if (lookup(k, e)) {
+      if (e.cost >= 0) { local.table_hits++; return e.cost; }
+      if (e.lower_bound >= budget) { local.table_hits++; return e.lower_bound; }
+    }
+  }
+
+  local.nodes++;
+
+  std::vector< int > members;
+  members.reserve(n);
+  for (auto i : candidates) members.push_back(int(i));
+
+  // rank the guesses by how well they could possibly do, which is
+  // both a good search order and a bound for cutting off the search
+  // ties, which are common under the weak bounds, go to the guess that
+  // leaves the fewest candidates on average
+  struct Option { int bound; uint64_t spread; int guess; };
+  std::vector< Option > ranked;
+  uint32_t counts[num_patterns];
+  auto consider = [&](int g) {
+    auto row = patterns.row(g);
+    for (auto i : members) counts[row[i]] = 0;
+    int buckets = 0;
+    int bound = (options.cost == TOTAL_GUESSES) ? int(n) : 1;
+    int worst = 0;
+    uint64_t spread = 0;
+    for (auto i : members) {
+      uint8_t c = row[i];
+      if (counts[c]++ == 0) buckets++;
+    }
+    for (auto i : members) {
+      uint8_t c = row[i];
+      if (counts[c] == 0) continue;
+      uint32_t size = counts[c];
+      counts[c] = 0;
+      spread += uint64_t(size) * size;
+      if (c == all_green) continue;
+      if (options.cost == TOTAL_GUESSES) {
+        bound += lower_bound(size);
+      } else {
+        worst = std::max(worst, lower_bound(size));
+      }
+    }
+    if (options.cost == MAX_GUESSES) bound += worst;
+
+    // a guess that leaves every candidate in one bucket learns nothing
+    bool learns_nothing = (buckets == 1 && row[members[0]] != all_green);
+    if (!learns_nothing) ranked.push_back(Option{bound, spread, g});
+  };
+
+  if (only_guess >= 0) {
+    consider(only_guess);
+  } else {
+    for (int g = 0; g < int(patterns.num_guesses); g++) consider(g);
+  }
+
+  std::sort(ranked.begin(), ranked.end(), [](Option a, Option b) {
+    if (a.bound != b.bound) return a.bound < b.bound;
+    return (a.spread != b.spread) ? a.spread < b.spread : a.guess < b.guess;
+  });
+
+  if (options.breadth > 0 && ranked.size() > size_t(options.breadth)) {
+    ranked.resize(options.breadth);
+  }
+
+  Best best(budget);
+  auto try_option = [&](Option option) {
+    // bounds never get looser, so this also stops the search
+    // once some guess is known to be as good as it gets
+    if (option.bound >= best.cost) return;
+    int cost = evaluate(candidates, members, option.guess, option.bound, guesses_left, best);
+    best.update(cost, option.guess);
+  };
+
+  if (n >= size_t(options.task_size) && ranked.size() > 1) {
+    ThreadPool::TaskGroup group;
+    for (auto option : ranked) {
+      pool.run(group, [&try_option, option](){ try_option(option); });
+    }
+    pool.wait(group);
+  } else {
+    for (auto option : ranked) {
+      // the options are in order, so none of the rest can do better either
+      if (option.bound >= best.cost) break;
+      try_option(option);
+    }
+  }
+
+  if (memoized) {
+    store(k, best.cost, best.guess);
+  } else if (best.guess >= 0) {
+    root_guess = best.guess;
+  }
+
+  return best.cost;
+
+}
+
+int TreeSearch::evaluate(const CandidateSet & candidates, const std::vector< int > & members,
+                         int guess, int bound, int guesses_left, const Best & best) {
+
+  // group the candidates by the feedback they'd give, biggest groups first
+  // since those are the likeliest to show this guess isn't good enough
+  auto row = patterns.row(guess);
+  uint32_t start[num_patterns + 1]{};
+  for (auto i : members) start[row[i] + 1]++;
+  std::vector< std::pair< uint32_t, uint8_t > > buckets;
+  for (int c = 0; c < int(num_patterns); c++) {
+    if (start[c + 1] > 0 && c != all_green) buckets.push_back({start[c + 1], uint8_t(c)});
+    start[c + 1] += start[c];
+  }
+  uint32_t next[num_patterns];
+  std::copy(start, start + num_patterns, next);
+  std::vector< int > sorted(members.size());
+  for (auto i : members) sorted[next[row[i]]++] = i;
+  std::sort(buckets.begin(), buckets.end(), [](auto a, auto b) { return a.first > b.first; });
+
+  // how much the buckets searched so far went over their lower bounds
+  // (for the total), or the most guesses any of them took (for the max)
+  std::atomic< int > excess{0};
+  std::atomic< int > deepest{1};
+  std::atomic< bool > beaten{false};
+
+  auto visit = [&](uint32_t size, uint8_t c) {
+    if (beaten) return;
+
+    CandidateSet child(candidates.n);
+    for (uint32_t k = start[c]; k < start[c] + size; k++) child.insert(sorted[k]);
+
+    if (options.cost == TOTAL_GUESSES) {
+      int fewest = lower_bound(size);
+      int budget = best.cost - (bound - fewest + excess);
+      int cost = search(child, guesses_left - 1, budget);
+      if (cost >= budget) {
+        beaten = true;
+      } else {
+        excess += cost - fewest;
+      }
+    } else {
+      int cost = 1 + search(child, guesses_left - 1, best.cost - 1);
+      if (cost >= best.cost) beaten = true;
+      int d = deepest;
+      while (cost > d && !deepest.compare_exchange_weak(d, cost)) {}
+    }
+  };
+
+  // the large buckets are searched side by side, and the rest in turn
+  size_t num_large = 0;
+  while (num_large < buckets.size() && buckets[num_large].first >= uint32_t(options.task_size)) num_large++;
+  if (num_large > 1) {
+    ThreadPool & pool = thread_pool();
+    ThreadPool::TaskGroup group;
+    for (size_t b = 0; b < num_large; b++) {
+      pool.run(group, [&visit, bucket = buckets[b]](){ visit(bucket.first, bucket.second); });
+    }
+    pool.wait(group);
+  } else {
+    num_large = 0;
+  }
+  for (size_t b = num_large; b < buckets.size() && !beaten; b++) {
+    visit(buckets[b].first, buckets[b].second);
+  }
+
+  if (beaten) return infinity;
+  return (options.cost == TOTAL_GUESSES) ? bound + excess : int(deepest);
+
+}
+
+int TreeSearch::build(const CandidateSet & candidates, int guesses_left, DecisionTree & tree, int depth) {
+
+  int index = int(tree.nodes.size());
+  tree.nodes.push_back(DecisionTree::Node{-1, {}});
+
+  size_t n = candidates.size();
+  int guess;
+  if (n == 1) {
+    guess = answer_guess[candidates.first()];
+  } else if (index == 0 && options.first_guess >= 0) {
+    guess = root_guess;
+  } else {
+    Entry e;
+    if (!lookup(key(candidates, guesses_left), e) || e.cost < 0) {
+      // the search skips pairs, since guessing either one is optimal
+      guess = answer_guess[candidates.first()];
+    } else {
+      guess = e.guess;
+    }
+  }
+  tree.nodes[index].guess = guess;
+
+  auto row = patterns.row(guess);
+  for (int c = 0; c < int(num_patterns); c++) {
+    CandidateSet child = select(row, candidates, uint8_t(c));
+    if (child.empty()) continue;
+
+    // the answer (if it's still a candidate) is found right here
+    if (c == all_green) {
+      tree.total_guesses += depth;
+      tree.max_guesses = std::max(tree.max_guesses, depth);
+      continue;
+    }
+
+    int child_index = build(child, guesses_left - 1, tree, depth + 1);
+    tree.nodes[index].children.push_back({uint8_t(c), child_index});
+  }
+
+  return index;
+
+}
+
+DecisionTree TreeSearch::solve(const CandidateSet & answers) {
+  PROFILE_ZONE("tree search");
+
+  DecisionTree tree{};
+
+  int cost = 0;
+  seconds += runtime([&](){
+    cost = search(answers, options.max_guesses, infinity, options.first_guess);
+  });
+
+  if (cost >= infinity || answers.empty()) return tree;
+
+  build(answers, options.max_guesses, tree, 1);
+  return tree;
+
+}
+
+SearchStats TreeSearch::stats() const {
+  SearchStats total{0, 0, seconds};
+  for (auto & c : counters) {
+    total.nodes += c.nodes;
+    total.table_hits += c.table_hits;
+  }
+  return total;
+}
+
+size_t TreeSearch::table_size() const {
+  size_t n = 0;
+  for (auto & shard : table) n += shard.entries.size();
+  return n;
+}
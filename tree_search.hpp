@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "wordle_tools.hpp"
+#include "decision_tree.hpp"
+#include "pattern_matrix.hpp"
+
+// what an optimal strategy should minimize
+enum TreeCost {
+  TOTAL_GUESSES, // summed over every answer, i.e. the average number of guesses
+  MAX_GUESSES    // for the hardest answer
+};
+
+struct SearchOptions {
+  TreeCost cost = TOTAL_GUESSES;
+
+  // how many guesses to consider at each node, best-first by a lower bound
+  // on their cost. 0 means all of them, which makes the result exactly
+  // optimal but is only feasible for small sets of answers.
+  int breadth = 20;
+
+  // strategies may not take more guesses than this for any answer
+  int max_guesses = 6;
+
+  // if nonnegative, the first guess is fixed to all_words[first_guess]
+  int first_guess = -1;
+
+  // sets of at least this many candidates are split into tasks on the
+  // thread pool: one per guess tried, and one per bucket that is this large
+  int task_size = 64;
+};
+
+struct SearchStats {
+  uint64_t nodes;       // sets of candidates that were actually searched
+  uint64_t table_hits;  // sets whose answer was already in the table
+  double seconds;
+
+  double nodes_per_second() const { return seconds > 0 ? nodes / seconds : 0.0; }
+};
+
+// Exhaustive depth-first search for the decision tree with the lowest cost.
+// Solved sets of candidates are memoized in a transposition table, and a
+// guess is abandoned as soon as a lower bound on its cost (every remaining
+// answer solved in as few guesses as is conceivable) can't beat the best found.
+//
+// Large sets are searched in parallel. Guesses tried at the same node share
+// the best cost found so far, so one task finding a good tree immediately
+// tightens the budget of the others, and so do the buckets of one guess.
+class TreeSearch {
+ public:
+  TreeSearch(const PatternMatrix & patterns, SearchOptions options = SearchOptions{});
+
+  // the best strategy for finding any one of the given answers
+  DecisionTree solve(const CandidateSet & answers);
+
+  SearchStats stats() const;
+  size_t table_size() const;
+
+ private:
+  static constexpr int infinity = 1 << 28;
+
+  struct Key {
+    uint64_t fingerprint[2];
+    int guesses_left;
+    bool operator==(const Key & other) const {
+      return fingerprint[0] == other.fingerprint[0] && fingerprint[1] == other.fingerprint[1] && guesses_left == other.guesses_left;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key & k) const { return size_t(k.fingerprint[0] ^ uint64_t(k.guesses_left)); }
+  };
+
+  struct Entry {
+    int lower_bound;   // the cost is at least this
+    int cost;          // the exact cost, or -1 if not known yet
+    int guess;         // a guess achieving it
+  };
+
+  // the fewest guesses it could possibly take to solve n candidates
+  int lower_bound(size_t n) const;
+
+  // the best cost found so far at one node, shared by the tasks working on it
+  struct Best {
+    std::atomic< int > cost;
+    int guess = -1;
+    std::mutex mutex;
+
+    explicit Best(int budget) : cost(budget) {}
+    void update(int new_cost, int new_guess);
+  };
+
+  // The cost of solving `candidates` in at most `guesses_left` guesses if that
+  // is less than `budget`, or otherwise some value >= budget.
+  int search(const CandidateSet & candidates, int guesses_left, int budget, int only_guess = -1);
+
+  // the cost of making `guess` first, if it is less than best.cost, or
+  // otherwise some value >= best.cost (which may drop during the call)
+  int evaluate(const CandidateSet & candidates, const std::vector< int > & members,
+               int guess, int bound, int guesses_left, const Best & best);
+
+  bool lookup(const Key & k, Entry & e);
+  void store(const Key & k, int cost, int guess);
+
+  // adds the subtree for candidates to the tree, from the solved table entries,
+  // and returns the index of its root node
+  int build(const CandidateSet & candidates, int guesses_left, DecisionTree & tree, int depth);
+
+  Key key(const CandidateSet & candidates, int guesses_left) const;
+
+  const PatternMatrix & patterns;
+  SearchOptions options;
+  double seconds;
+
+  // one per thread, padded so they don't share cache lines
+  struct alignas(64) Counters {
+    uint64_t nodes;
+    uint64_t table_hits;
+  };
+  std::vector< Counters > counters;
+
+  // the guess that confirms each answer, or -1 if it isn't a valid guess
+  std::vector< int > answer_guess;
+
+  // the best guess at the root, when options.first_guess isn't fixed
+  // (in which case it comes from the table like every other node)
+  int root_guess;
+
+  // the transposition table, split into shards with a lock each
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map< Key, Entry, KeyHash > entries;
+  };
+  static constexpr int num_shards = 64;
+  std::array< Shard, num_shards > table;
+};
@@ -1,43 +1,61 @@
+#pragma once
+
 #include <string>
+#include <cstdint>
 #include <iostream>
 #include <algorithm> // for std::copy
 
 constexpr size_t word_length = 5;
 struct Word {
-  Word() : data{} {}
+  constexpr Word() : data{} {}
   Word(std::string str) { 
     if (str.size() != word_length) { exit(1); }
     std::copy(str.begin(), str.end(), data); 
   }
-  Word(const char tmp[6]) { std::copy(tmp, tmp+word_length, data); }
+  // only string literals of exactly 5 letters, so that two literals
+  // accidentally joined by a missing comma fail to compile
+  template < size_t N >
+  constexpr Word(const char (&tmp)[N]) : data{} { 
+    static_assert(N == word_length + 1, "a word must have exactly 5 letters");
+    for (int i = 0; i < word_length; i++) data[i] = tmp[i]; 
+  }
   char data[word_length]; 
 
-  bool contains(char c) const {
+  constexpr bool contains(char c) const {
     for (int i = 0; i < word_length; i++) {
       if (c == data[i]) { return true; }
     }
     return false;
   }
 
-  int find(char c) const {
+  constexpr int find(char c) const {
     for (int i = 0; i < word_length; i++) {
       if (c == data[i]) { return i; }
     }
     return -1;
   }
 
-  char & operator[](int i) { return data[i]; }
-  const char & operator[](int i) const { return data[i]; }
+  constexpr char & operator[](int i) { return data[i]; }
+  constexpr const char & operator[](int i) const { return data[i]; }
 };
 
-inline uint32_t letter_mask(Word w) {
+constexpr bool operator==(Word a, Word b) {
+  for (int i = 0; i < word_length; i++) {
+    if (a[i] != b[i]) return false;
+  }
+  return true;
+}
+
+constexpr bool operator!=(Word a, Word b) { return !(a == b); }
+
+constexpr uint32_t letter_mask(Word w) {
   constexpr uint32_t one = 1;
   uint32_t mask{}; 
   for (auto c : w.data) mask |= (one << (c - 'a')); 
   return mask;
 }
 
-inline uint32_t letter_mask(char c) { 
+constexpr uint32_t letter_mask(char c) { 
   if (c == '?') return uint32_t(0);
   else return uint32_t(1) << (c - 'a'); 
 }
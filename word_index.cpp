@@ -0,0 +1,34 @@
+#include "word_index.hpp"
+
+#include "wordle_tools.hpp"
+
+#include <algorithm>
+
+WordIndex::WordIndex(WordList words) {
+  sorted.reserve(words.size());
+  for (size_t i = 0; i < words.size(); i++) {
+    sorted.push_back(Entry{pack(words[i]).letters, uint32_t(i)});
+  }
+
+  // duplicates keep their earliest index, to agree with index_of()
+  std::stable_sort(sorted.begin(), sorted.end(), [](Entry a, Entry b) { return a.letters < b.letters; });
+}
+
+int WordIndex::find(PackedWord w) const {
+  auto it = std::lower_bound(sorted.begin(), sorted.end(), w.letters, [](Entry e, uint32_t letters) {
+    return e.letters < letters;
+  });
+  return (it != sorted.end() && it->letters == w.letters) ? int(it->index) : -1;
+}
+
+int WordIndex::find(Word w) const {
+  for (int i = 0; i < word_length; i++) {
+    if (w[i] < 'a' || w[i] > 'z') return -1;
+  }
+  return find(pack(w));
+}
+
+const WordIndex & words_index() {
+  static const WordIndex index(all_words);
+  return index;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "packed_word.hpp"
+#include "word_list.hpp"
+
+// Looks up a word's position in a list by binary search over the packed
+// letters, sorted once up front. Unlike index_of(), a lookup is a handful of
+// integer comparisons with no scan and no allocation, which is what input
+// from the outside (typed guesses, requests to a server) needs.
+class WordIndex {
+ public:
+  explicit WordIndex(WordList words);
+
+  // the index of w in the list, or -1 if it isn't there
+  int find(Word w) const;
+  int find(PackedWord w) const;
+
+  size_t size() const { return sorted.size(); }
+
+ private:
+  struct Entry {
+    uint32_t letters; // PackedWord::letters
+    uint32_t index;
+  };
+
+  std::vector< Entry > sorted;
+};
+
+// the index for all_words
+const WordIndex & words_index();
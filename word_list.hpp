@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+#include "word.hpp"
+
+// A read-only view of words stored contiguously elsewhere: in a std::vector,
+// a compiled-in array or a memory-mapped lexicon file. It is as cheap to copy
+// as a pointer, and the words have to outlive it.
+class WordList {
+ public:
+  constexpr WordList() : first(nullptr), n(0) {}
+  constexpr WordList(const Word * words, size_t n) : first(words), n(n) {}
+  WordList(const std::vector< Word > & words) : first(words.data()), n(words.size()) {}
+
+  template < size_t N >
+  constexpr WordList(const std::array< Word, N > & words) : first(words.data()), n(N) {}
+
+  constexpr size_t size() const { return n; }
+  constexpr bool empty() const { return n == 0; }
+
+  constexpr const Word & operator[](size_t i) const { return first[i]; }
+
+  constexpr const Word * data() const { return first; }
+  constexpr const Word * begin() const { return first; }
+  constexpr const Word * end() const { return first + n; }
+
+ private:
+  const Word * first;
+  size_t n;
+};
+
+static_assert(sizeof(Word) == word_length, "word lists are stored as packed 5-byte rows");
@@ -1,8 +1,7 @@
-#include <vector>
+#include "builtin_lexicon.hpp"
+#include "wordle_tools.hpp"
 
-#include "word.hpp"
-
-std::vector< Word > all_answers = {
+static constexpr Word answers[] = {
 "cigar", "rebut", "sissy", "humph", "awake", "blush", "focal",
 "evade", "naval", "serve", "heath", "dwarf", "model", "karma",
 "stink", "grade", "quiet", "bench", "abate", "feign", "major",
@@ -334,3 +333,14 @@ std::vector< Word > all_answers = {
 "login", "eject", "roger", "rival", "untie", "refit", "aorta",
 "adult", "judge", "rower", "artsy", "rural", "shave"
 };
+
+static_assert(builtin::all_lowercase(answers), "every entry must be a lowercase word");
+
+static constexpr auto columns = builtin::make_columns(answers);
+
+constexpr BuiltinLexicon builtin_answers = builtin::make_lexicon(answers, columns);
+
+#if defined(WORDLE_EMBEDDED_LEXICON)
+// defined here, next to the list itself, so it is constant-initialized
+const WordList all_answers = builtin_answers.words;
+#endif
@@ -0,0 +1,251 @@
+#include "wordle_tools.hpp"
+#include "kernels.hpp"
+#include "thread_pool.hpp"
+#include "perf_counters.hpp"
+
+#include "timer.hpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
+// keeps the compiler from optimizing away a result we never look at
+template < typename T >
+inline void keep(const T & value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+struct Result {
+  std::string name;
+  size_t size;             // candidates, words etc. per operation
+  size_t samples;
+  double ns_per_op;        // mean over the samples
+  double stddev_ns;
+  double min_ns;
+  double ops_per_second;
+  double items_per_second; // size * ops_per_second
+
+  // hardware events per op, over all the samples
+  double per_op[PerfCounters::num_events];
+  bool counted[PerfCounters::num_events];
+};
+
+struct Options {
+  size_t samples = 10;
+  double seconds_per_sample = 0.01;
+  std::string filter;
+  bool json = false;
+  bool counters = true;
+};
+
+Options options;
+std::vector< Result > results;
+
+// null if disabled with --no-counters
+PerfCounters * counters = nullptr;
+
+// Times f(), which does `ops` operations on `size` items each. The number of
+// repetitions per sample is picked so each sample takes seconds_per_sample.
+template < typename callable >
+void benchmark(const std::string & name, size_t size, size_t ops, callable f) {
+  if (name.find(options.filter) == std::string::npos) return;
+
+  // warm up the caches (and any lazily built tables), then calibrate
+  f();
+  size_t reps = 1;
+  while (true) {
+    double seconds = runtime([&](){ for (size_t r = 0; r < reps; r++) f(); });
+    if (seconds >= options.seconds_per_sample || reps >= (size_t(1) << 30)) break;
+    reps = (seconds > 0) ? std::max(reps + 1, size_t(reps * options.seconds_per_sample / seconds * 1.1)) : reps * 10;
+  }
+
+  std::vector< double > ns(options.samples);
+  if (counters) counters->start();
+  for (auto & sample : ns) {
+    double seconds = runtime([&](){ for (size_t r = 0; r < reps; r++) f(); });
+    sample = seconds * 1.0e9 / double(reps * ops);
+  }
+  if (counters) counters->stop();
+
+  double mean = 0;
+  for (auto x : ns) mean += x;
+  mean /= ns.size();
+
+  double variance = 0;
+  for (auto x : ns) variance += (x - mean) * (x - mean);
+  variance /= std::max(ns.size(), size_t(2)) - 1;
+
+  Result r;
+  r.name = name;
+  r.size = size;
+  r.samples = ns.size();
+  r.ns_per_op = mean;
+  r.stddev_ns = std::sqrt(variance);
+  r.min_ns = *std::min_element(ns.begin(), ns.end());
+  r.ops_per_second = 1.0e9 / mean;
+  r.items_per_second = size * r.ops_per_second;
+
+  PerfCounters::Reading reading = counters ? counters->read() : PerfCounters::Reading{};
+  for (int e = 0; e < PerfCounters::num_events; e++) {
+    r.counted[e] = reading.valid[e];
+    r.per_op[e] = reading.valid[e] ? double(reading.value[e]) / double(ns.size() * reps * ops) : 0.0;
+  }
+  results.push_back(r);
+
+  if (!options.json) {
+    std::cout << std::left << std::setw(28) << name << std::right << std::setw(8) << size;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(14) << mean << " ns/op";
+    std::cout << std::setw(10) << 100.0 * r.stddev_ns / mean << "%";
+    std::cout << std::scientific << std::setprecision(3);
+    std::cout << std::setw(14) << r.items_per_second << " items/s";
+    std::cout << std::fixed << std::setprecision(2);
+    for (int e = 0; e < PerfCounters::num_events; e++) {
+      if (r.counted[e]) std::cout << "  " << PerfCounters::name(PerfCounters::Event(e)) << ": " << r.per_op[e];
+    }
+    if (r.counted[PerfCounters::CYCLES] && r.counted[PerfCounters::INSTRUCTIONS]) {
+      std::cout << "  ipc: " << r.per_op[PerfCounters::INSTRUCTIONS] / r.per_op[PerfCounters::CYCLES];
+    }
+    std::cout << std::endl;
+    std::cout << std::defaultfloat;
+  }
+}
+
+// The output format is versioned; new fields may be added, but existing ones
+// keep their names and meaning so results can be compared across releases.
+void print_json() {
+  std::cout << std::setprecision(6);
+  std::cout << "{\n";
+  std::cout << "  \"version\": 1,\n";
+  std::cout << "  \"kernels\": \"" << kernel_name() << "\",\n";
+  std::cout << "  \"threads\": " << thread_pool().size() << ",\n";
+  std::cout << "  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result & r = results[i];
+    std::cout << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size;
+    std::cout << ", \"samples\": " << r.samples;
+    std::cout << ", \"ns_per_op\": " << r.ns_per_op;
+    std::cout << ", \"stddev_ns\": " << r.stddev_ns;
+    std::cout << ", \"min_ns\": " << r.min_ns;
+    std::cout << ", \"ops_per_second\": " << r.ops_per_second;
+    std::cout << ", \"items_per_second\": " << r.items_per_second;
+
+    // per op, or null where the counter wasn't available
+    for (int e = 0; e < PerfCounters::num_events; e++) {
+      std::cout << ", \"" << PerfCounters::name(PerfCounters::Event(e)) << "\": ";
+      if (r.counted[e]) {
+        std::cout << r.per_op[e];
+      } else {
+        std::cout << "null";
+      }
+    }
+    std::cout << "}";
+    std::cout << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  std::cout << "  ]\n";
+  std::cout << "}" << std::endl;
+}
+
+void usage() {
+  std::cout << "usage: wordle_bench [--json] [--filter NAME] [--samples N] [--seconds S] [--threads N] [--no-counters]" << std::endl;
+  exit(1);
+}
+
+int main(int argc, char * argv[]) {
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--json") {
+      options.json = true;
+    } else if (arg == "--filter" && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (arg == "--samples" && i + 1 < argc) {
+      options.samples = size_t(std::max(std::atoi(argv[++i]), 1));
+    } else if (arg == "--seconds" && i + 1 < argc) {
+      options.seconds_per_sample = std::atof(argv[++i]);
+    } else if (arg == "--no-counters") {
+      options.counters = false;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      set_num_threads(std::max(std::atoi(argv[++i]), 1));
+    } else {
+      usage();
+    }
+  }
+
+  PerfCounters perf;
+  if (options.counters) {
+    counters = &perf;
+    if (!perf.any_available()) {
+      std::cerr << "hardware counters are unavailable here, so only times are reported" << std::endl;
+    }
+  }
+
+  // a fixed seed, so every run measures the same inputs
+  std::mt19937 generator(12345);
+  auto random_index = [&](size_t n) { return std::uniform_int_distribution< size_t >(0, n - 1)(generator); };
+
+  constexpr size_t num_pairs = 1024;
+  std::vector< Word > answers(num_pairs), guesses(num_pairs);
+  std::vector< State > states(num_pairs);
+  for (size_t i = 0; i < num_pairs; i++) {
+    answers[i] = all_answers[random_index(all_answers.size())];
+    guesses[i] = all_words[random_index(all_words.size())];
+    states[i] = check(answers[i], guesses[i]);
+  }
+
+  benchmark("get_clues", 1, num_pairs, [&](){
+    for (size_t i = 0; i < num_pairs; i++) keep(get_clues(answers[i], guesses[i]));
+  });
+
+  benchmark("check", 1, num_pairs, [&](){
+    for (size_t i = 0; i < num_pairs; i++) keep(check(answers[i], guesses[i]));
+  });
+
+  benchmark("check_pattern", 1, num_pairs, [&](){
+    for (size_t i = 0; i < num_pairs; i++) keep(check_pattern(answers[i], guesses[i]));
+  });
+
+  benchmark("combine", 1, num_pairs - 1, [&](){
+    for (size_t i = 0; i + 1 < num_pairs; i++) keep(combine(states[i], states[i + 1]));
+  });
+
+  // a typical state after one guess
+  State s = check(answers[0], "aloes");
+
+  benchmark("is_consistent_with", 1, all_words.size(), [&](){
+    size_t count = 0;
+    for (auto w : all_words) count += s.is_consistent_with(w);
+    keep(count);
+  });
+
+  std::vector< PackedWord > packed = pack(all_words);
+  benchmark("is_consistent_with/packed", 1, packed.size(), [&](){
+    size_t count = 0;
+    for (auto w : packed) count += s.is_consistent_with(w);
+    keep(count);
+  });
+
+  for (size_t size : {size_t(64), size_t(1024), all_words.size()}) {
+    std::vector< Word > words(all_words.begin(), all_words.begin() + size);
+    benchmark("select", size, 1, [&](){ keep(select(words, s)); });
+    benchmark("num_remaining_words", size, 1, [&](){ keep(num_remaining_words(words, s)); });
+
+    CandidateSet candidates = CandidateSet::all(all_words.size());
+    for (size_t i = size; i < all_words.size(); i++) candidates.erase(i);
+    benchmark("select/candidates", size, 1, [&](){ keep(select(all_words, candidates, s)); });
+  }
+
+  // random sets of possible answers, as the solver would see them after a guess or two
+  for (size_t size : {size_t(2), size_t(16), size_t(128), all_answers.size()}) {
+    CandidateSet candidates(all_answers.size());
+    while (candidates.size() < size) candidates.insert(random_index(all_answers.size()));
+    benchmark("best_guess_brute_force", size, 1, [&](){ keep(best_guess_brute_force(candidates)); });
+  }
+
+  if (options.json) print_json();
+
+}
@@ -1,10 +1,32 @@
 #include "wordle_tools.hpp"
 
 #include "color.hpp"
-
+#include "kernels.hpp"
+#include "opening_book.hpp"
+#include "pattern_matrix.hpp"
+#include "pattern_index.hpp"
+#include "profiler.hpp"
+#include "scoring.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <chrono>
 #include <random>
+#include <limits>
+
+std::vector< PackedWord > pack(WordList words) {
+  std::vector< PackedWord > packed(words.size());
+  std::transform(words.begin(), words.end(), packed.begin(), [](Word w){ return pack(w); });
+  return packed;
+}
+
+int index_of(WordList words, Word w) {
+  auto it = std::find(words.begin(), words.end(), w);
+  return (it == words.end()) ? -1 : int(it - words.begin());
+}
 
-Word random(const std::vector< Word > & words) {
+Word random(WordList words) {
   static unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
   static std::default_random_engine generator(seed);
   static std::uniform_int_distribution<int> distribution(0, words.size() - 1);
@@ -63,125 +85,202 @@ void print(State s) {
   std::cout << std::endl;
 }
 
-std::vector< Word > select(const std::vector < Word > & words, const State & s) {
+std::vector< Word > select(WordList words, const State & s) {
+  PROFILE_ZONE("filter words");
+  std::vector< uint64_t > bits((words.size() + 63) / 64);
+  consistent(s, words.data(), words.size(), bits.data());
+
   std::vector < Word > filtered;
-  for (auto & word : words) {
-    if (s.is_consistent_with(word)) {
-      filtered.push_back(word);
+  for (size_t i = 0; i < bits.size(); i++) {
+    for (uint64_t b = bits[i]; b != 0; b &= b - 1) {
+      filtered.push_back(words[i * 64 + __builtin_ctzll(b)]);
     }
   } 
   return filtered;
 }
 
-size_t num_remaining_words(const std::vector < Word > & words, const State & s) {
+size_t num_remaining_words(WordList words, const State & s) {
+  std::vector< uint64_t > bits((words.size() + 63) / 64);
+  consistent(s, words.data(), words.size(), bits.data());
+
   size_t remaining = 0;
-  for (auto & word : words) { remaining += s.is_consistent_with(word); } 
+  for (auto b : bits) { remaining += __builtin_popcountll(b); } 
   return remaining;
 }
 
-std::array<Clue, 5> get_clues(Word answer, Word guess) {
-  std::array<Clue, 5> output;
-
-  for (int i = 0; i < word_length; i++) {
-    if (guess[i] == answer[i]) {
-      output[i] = GREEN;
-    } else {
-      bool misplaced = false;
-      for (int j = 0; j < word_length; j++) {
-        if (guess[i] == answer[j] && guess[j] != answer[j]) {
-          misplaced = true;
-          break;
-        }
-      }
-      output[i] = misplaced ? YELLOW : GRAY;
-    }
+// only the blocks of 64 words that still have candidates in them get filtered
+template < typename callable >
+static void for_each_consistent_block(WordList words, const CandidateSet & candidates, const State & s, callable f) {
+  for (uint32_t b = 0; b < candidates.active_blocks(); b++) {
+    if (candidates.blocks[b] == 0) continue;
+    size_t begin = size_t(b) * 64;
+    uint64_t bits;
+    consistent(s, &words[begin], std::min(words.size() - begin, size_t(64)), &bits);
+    f(b, bits & candidates.blocks[b]);
   }
+}
+
+CandidateSet select(WordList words, const CandidateSet & candidates, const State & s) {
+  PROFILE_ZONE("filter words");
+  CandidateSet filtered(candidates.n);
+  for_each_consistent_block(words, candidates, s, [&](uint32_t b, uint64_t bits) {
+    filtered.blocks[b] = bits;
+  });
+  return filtered;
+}
 
-  return output;
+size_t num_remaining_words(WordList words, const CandidateSet & candidates, const State & s) {
+  size_t remaining = 0;
+  for_each_consistent_block(words, candidates, s, [&](uint32_t, uint64_t bits) {
+    remaining += __builtin_popcountll(bits);
+  });
+  return remaining;
 }
 
 State check(Word answer, Word guess) {
   State feedback{};
-
-  bool matching[word_length];
-
-  // first get all the matched letters
-  for (int i = 0; i < word_length; i++) {
-    matching[i] = (answer[i] == guess[i]);
-    if (matching[i]) feedback.matched[i] = answer[i];
-  }
-
-  // then get all the unused / misplaced letters
-  for (int i = 0; i < word_length; i++) {
-    int location = answer.find(guess[i]);
-    if (location == -1) {
-      feedback.unused |= letter_mask(guess[i]);
-    } else {
-      if (!matching[location]) {
-        feedback.misplaced[i] |= letter_mask(guess[i]);
-      }
-    }
-  }
-
+  feedback.update(check_pattern(answer, guess), guess);
   return feedback;
 }
 
-auto best_guess_brute_force(const std::vector < Word > & possible_words, State clues) {
+int best_guess_brute_force(const CandidateSet & possible_answers, Objective objective) {
+  PROFILE_ZONE("score guesses");
+
+  const PatternMatrix & patterns = pattern_matrix();
 
-  float fewest_remaining = possible_words.size();
-  Word best_word;
+  // each chunk of guesses finds its own best, which is then merged into this
+  // call's overall best; nothing is kept per thread, so any number of threads
+  // can be in here at once
+  struct Best {
+    float cost;
+    int guess;
 
-  for (auto word : all_words) {
-    size_t remaining = 0;
-    for (auto answer : possible_words) {
-      auto new_clues = combine(clues, check(answer, word));
-      remaining = std::max(remaining, num_remaining_words(possible_words, new_clues));
+    // ties go to the earliest guess in all_words, regardless of how
+    // the work happened to be divided up
+    void update(Best b) {
+      if (b.cost < cost || (b.cost == cost && b.guess < guess)) *this = b;
     }
+  };
+  ThreadPool & pool = thread_pool();
+  Best overall{std::numeric_limits<float>::max(), 0};
+  std::mutex overall_mutex;
+
+  // Small sets, as in the middle of most games, are scored by computing their
+  // patterns on the fly: one kernel call on a single block of candidates is
+  // much cheaper than the cache misses from reading a little of every row.
+  constexpr size_t small_set = 64;
+  size_t n = possible_answers.size();
+  bool small = (n <= small_set);
+  uint8_t letters[word_length][small_set];
+  const uint8_t * columns[word_length];
+  if (small) {
+    for (int j = 0; j < word_length; j++) {
+      std::fill(letters[j], letters[j] + small_set, uint8_t('a'));
+      columns[j] = letters[j];
+    }
+    size_t k = 0;
+    for (auto i : possible_answers) {
+      for (int j = 0; j < word_length; j++) letters[j][k] = uint8_t(all_answers[i][j]);
+      k++;
+    }
+  }
 
-    if (remaining < fewest_remaining) {
-      fewest_remaining = remaining;
-      best_word = word;
+  // A guess that gives every candidate its own pattern is as good as it gets
+  // under every objective, and ties go to the earliest guess, so once one is
+  // found there is no point scoring any guess that comes after it.
+  std::atomic< int > perfect{std::numeric_limits<int>::max()};
+
+  auto score_chunk = [&](size_t begin, size_t end) {
+    PROFILE_ZONE("score guess chunk");
+    Best local{std::numeric_limits<float>::max(), 0};
+    for (int guess = int(begin); guess < int(end); guess++) {
+      if (guess > perfect.load(std::memory_order_relaxed)) break;
+      Score s;
+      if (small) {
+        uint8_t codes[small_set];
+        pattern_codes(all_words[guess], columns, small_set, codes);
+        s = score(codes, n);
+      } else {
+        s = score(patterns.row(guess), possible_answers);
+      }
+      float cost = s.cost(objective);
+      if (s.worst_case <= 1) {
+        int current = perfect.load(std::memory_order_relaxed);
+        while (guess < current && !perfect.compare_exchange_weak(current, guess)) {}
+      }
+      local.update(Best{cost, guess});
     }
+    std::lock_guard< std::mutex > lock(overall_mutex);
+    overall.update(local);
+  };
+
+  // called from inside a task, e.g. a game in solve_all(), the pool is
+  // already busy one level up, so the guesses are scored right here
+  constexpr size_t guesses_per_task = 64;
+  if (pool.in_task()) {
+    score_chunk(0, patterns.num_guesses);
+  } else {
+    pool.parallel_for(patterns.num_guesses, guesses_per_task, score_chunk);
   }
 
-  return best_word;
+  return overall.guess;
 
 }
 
+int opening_guess() {
+  static const int opener = [](){
+    int aloes = index_of(all_words, "aloes");
+    return (aloes >= 0) ? aloes : best_guess_brute_force(CandidateSet::all(all_answers.size()));
+  }();
+  return opener;
+}
+
 int wordle_solve(Word answer, bool debug_print) {
+  PROFILE_ZONE("solve game");
 
   State clues{};
 
-  auto possible_words = all_words;
+  CandidateSet possible_answers = CandidateSet::all(all_answers.size());
 
-  Word guess = "aloes";
+  int guess = opening_guess();
+  std::vector< std::pair< int, uint8_t > > turns;
 
   for (int i = 1; i < 10; i++) {
+    PROFILE_ZONE("solve turn");
 
-    std::cout << "guess " << i << ": " << guess << std::endl;
-  
-    clues = combine(clues, check(answer, guess));
+    if (debug_print) std::cout << "guess " << i << ": " << all_words[guess] << std::endl;
 
-    possible_words = select(possible_words, clues);
+    uint8_t feedback = get_pattern(answer, all_words[guess]);
+    if (feedback == all_green) return i;
+
+    possible_answers = pattern_index().select(guess, possible_answers, feedback);
+    turns.push_back({guess, feedback});
 
     if (debug_print) { 
+      PROFILE_ZONE("print turn");
+      clues = combine(clues, check(answer, all_words[guess]));
       print(clues);
 
-      std::cout << possible_words.size() << " remaining words: " << std::endl;
+      std::cout << possible_answers.size() << " remaining words: " << std::endl;
       int count = 0;
-      for (auto word : possible_words) {
-        std::cout << word << ' ';
+      for (auto j : possible_answers) {
+        std::cout << all_answers[j] << ' ';
         if (++count % 16 == 0) std::cout << std::endl;
       }
       std::cout << std::endl;
       std::cout << std::endl;
     }
 
-    if (possible_words.size() == 1) { 
-      std::cout << "found " << possible_words[0] << " in " << i+1 << " guess(es)" << std::endl;
-      return i; 
+    size_t remaining = possible_answers.size();
+
+    // the last candidate still has to be guessed
+    if (remaining == 1) { 
+      if (debug_print) std::cout << "found " << all_answers[possible_answers.first()] << " in " << i+1 << " guess(es)" << std::endl;
+      return (all_answers[possible_answers.first()] == answer) ? i+1 : -1; 
+    } else if (remaining == 0) {
+      return -1;
     } else {
-      guess = best_guess_brute_force(possible_words, clues);
+      guess = best_guess(possible_answers, turns);
     }
 
   } 
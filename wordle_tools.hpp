@@ -1,14 +1,77 @@
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "word.hpp"
+#include "word_list.hpp"
+#include "packed_word.hpp"
+#include "candidate_set.hpp"
+
+// every valid guess, and the possible answers (see lexicon_file.hpp)
+extern const WordList all_words;
+extern const WordList all_answers;
+
+Word random(WordList words);
 
-extern std::vector < Word > all_words;
-extern std::vector < Word > all_answers;
+std::vector< PackedWord > pack(WordList words);
 
-Word random(const std::vector< Word > & words);
+// position of w in words, or -1 if it isn't there
+int index_of(WordList words, Word w);
 
 enum Clue { GRAY, YELLOW, GREEN };
 
+// A full set of clues packs into a single byte as a base-3 number in
+// [0, 243), with the first letter's clue as the most significant digit.
+constexpr size_t num_patterns = 243;
+
+constexpr uint8_t pattern_weight[word_length] = {81, 27, 9, 3, 1};
+
+constexpr uint8_t encode(std::array< Clue, 5 > clues) {
+  uint8_t code = 0;
+  for (int i = 0; i < word_length; i++) code += clues[i] * pattern_weight[i];
+  return code;
+}
+
+constexpr std::array< Clue, 5 > decode(uint8_t code) {
+  std::array< Clue, 5 > clues{};
+  for (int i = 0; i < word_length; i++) clues[i] = Clue((code / pattern_weight[i]) % 3);
+  return clues;
+}
+
+constexpr uint8_t all_green = encode({GREEN, GREEN, GREEN, GREEN, GREEN});
+
+// Letters in place are GREEN. Each other letter of the guess is YELLOW if the
+// answer has more copies of it, outside the GREEN positions, than are used up
+// by earlier non-GREEN copies in the guess, and otherwise GRAY. So a letter
+// guessed twice but in the answer once is YELLOW (or GREEN) only once.
+constexpr std::array<Clue, 5> get_clues(Word answer, Word guess) {
+  std::array<Clue, 5> output{};
+
+  for (int i = 0; i < word_length; i++) {
+    if (guess[i] == answer[i]) {
+      output[i] = GREEN;
+    } else {
+      int available = 0, earlier = 0;
+      for (int j = 0; j < word_length; j++) {
+        if (guess[i] == answer[j] && guess[j] != answer[j]) available++;
+        if (j < i && guess[j] == guess[i] && guess[j] != answer[j]) earlier++;
+      }
+      output[i] = (available > earlier) ? YELLOW : GRAY;
+    }
+  }
+
+  return output;
+}
+
+// get_clues(), as a pattern code
+constexpr uint8_t get_pattern(Word answer, Word guess) {
+  return encode(get_clues(answer, guess));
+}
+
+// the different ways of judging a guess from how it partitions the possible answers
+enum Objective { WORST_CASE, EXPECTED_SIZE, ENTROPY };
+
 struct State {
 
   char matched[word_length];
@@ -19,10 +82,22 @@ struct State {
   // '?' here will denote we haven't found a match
   State() : matched{'?', '?', '?', '?', '?'}, misplaced{}, unused{}, used{}{}
 
+  void update(uint8_t pattern, Word word) { update(decode(pattern), word); }
+
   void update(std::array< Clue, 5 > clues, Word word) {
+    uint32_t found = 0;
+    for (int i = 0; i < 5; i++) {
+      if (clues[i] != GRAY) found |= letter_mask(word[i]);
+    }
+
     for (int i = 0; i < 5; i++) {
       auto mask = letter_mask(word[i]);
-      if (clues[i] == GRAY) unused |= mask;
+
+      // a GRAY copy of a letter that is GREEN or YELLOW elsewhere only says
+      // the answer has no further copies, so it just rules out this position
+      if (clues[i] == GRAY) {
+        if (mask & found) misplaced[i] |= mask; else unused |= mask;
+      }
       if (clues[i] == GREEN) matched[i] = word[i];
       if (clues[i] == YELLOW) misplaced[i] |= mask;
       if (clues[i] == GREEN || clues[i] == YELLOW) { used |= mask; }
@@ -71,39 +146,84 @@ struct State {
 
     return true;
   }
+
+  // the same check, for a word whose letter mask has already been computed
+  bool is_consistent_with(PackedWord word) const {
+
+    if ((word.mask & used) != used) return false;
+
+    if (word.mask & unused) return false;
+
+    for (int i = 0; i < word_length; i++) {
+      uint32_t c = word.code(i);
+      if (matched[i] != '?' && matched[i] != char('a' + c)) return false; 
+      if ((misplaced[i] >> c) & 1) return false; 
+    }
+
+    return true;
+  }
 };
 
 State combine(State a, State b);
 
 void print(State s);
 
-std::vector< Word > select(const std::vector < Word > & words, const State & s);
+std::vector< Word > select(WordList words, const State & s);
+
+size_t num_remaining_words(WordList words, const State & s);
 
-size_t num_remaining_words(const std::vector < Word > & words, const State & s);
+// the same, restricted to a set of candidates (indices into words)
+CandidateSet select(WordList words, const CandidateSet & candidates, const State & s);
 
+size_t num_remaining_words(WordList words, const CandidateSet & candidates, const State & s);
+
+// what guessing guess tells us about answer
 State check(Word answer, Word guess);
 
-auto best_guess_brute_force(const std::vector < Word > & possible_words, State clues);
+// check(), as a pattern code: the same feedback in one byte instead of a State,
+// so State().update(check_pattern(answer, guess), guess) is check(answer, guess)
+constexpr uint8_t check_pattern(Word answer, Word guess) { return get_pattern(answer, guess); }
+
+// the index (into all_words) of the guess that best splits up the possible answers
+// (indices into all_answers), by default minimizing the worst-case number remaining
+int best_guess_brute_force(const CandidateSet & possible_answers, Objective objective = WORST_CASE);
+
+// the index (into all_words) of the first guess: a good opener, or the best
+// one for whatever word list was loaded
+int opening_guess();
 
 int wordle_solve(Word answer, bool debug_print = false);
 
 void delete_line();
 
-std::array<Clue, 5> get_clues(Word answer, Word guess);
-
 void print(std::array< Clue, 5 > clues, Word guess);
 
 std::ostream& operator<<(std::ostream & out, std::array< Clue, 5 > clues);
 
-static constexpr std::array< std::array<Clue,5>, 243> all_clues = [](){
-  std::array< std::array<Clue,5>, 243> clues{};
+// decode() for every pattern code, i.e. all_clues[encode(clues)] == clues
+static constexpr std::array< std::array<Clue,5>, num_patterns > all_clues = [](){
+  std::array< std::array<Clue,5>, num_patterns > clues{};
   int count = 0;
   for (int i = 0; i < 3; i++) {
   for (int j = 0; j < 3; j++) {
   for (int k = 0; k < 3; k++) {
   for (int l = 0; l < 3; l++) {
   for (int m = 0; m < 3; m++) {
-    clues[count] = std::array{(Clue)i, (Clue)j, (Clue)k, (Clue)l, (Clue)m};
+    clues[count++] = std::array{(Clue)i, (Clue)j, (Clue)k, (Clue)l, (Clue)m};
   }}}}}
   return clues;
-}();
\ No newline at end of file
+}();
+
+static_assert([](){
+  for (int code = 0; code < int(num_patterns); code++) {
+    if (encode(all_clues[code]) != code || encode(decode(code)) != code) return false;
+  }
+  return true;
+}());
+
+static_assert(all_green == 242 && get_pattern("truth", "truth") == all_green);
+static_assert(get_pattern("cigar", "crane") == encode({GREEN, YELLOW, YELLOW, GRAY, GRAY}));
+static_assert(get_pattern("abcde", "eexxx") == encode({YELLOW, GRAY, GRAY, GRAY, GRAY}));
+static_assert(get_pattern("abide", "speed") == encode({GRAY, GRAY, YELLOW, GRAY, YELLOW}));
+static_assert(get_pattern("erase", "speed") == encode({YELLOW, GRAY, YELLOW, YELLOW, GRAY}));
+static_assert(get_pattern("steal", "speed") == encode({GREEN, GRAY, GREEN, GRAY, GRAY}));